@@ -0,0 +1,96 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+#include "AVLNodePool.h"
+#include <algorithm>
+
+AVLNodePool::AVLNodePool(size_t blocksPerSlab, std::pmr::memory_resource *upstream)
+    : upstream(upstream), blocksPerSlab(std::max<size_t>(blocksPerSlab, 1)), requestBytes(0), requestAlign(0),
+      blockSize(0), blockAlign(0),
+      freeList(nullptr), slabs(nullptr), numSlabs(0), nextUnused(nullptr), slabEnd(nullptr) {
+}
+
+AVLNodePool::~AVLNodePool() {
+    release();
+}
+
+void AVLNodePool::release() {
+    while (slabs) {
+        Slab *next = slabs->next;
+        upstream->deallocate(slabs, slabs->bytes, alignof(std::max_align_t));
+        slabs = next;
+    }
+    freeList = nullptr;
+    numSlabs = 0;
+    nextUnused = nullptr;
+    slabEnd = nullptr;
+}
+
+size_t AVLNodePool::slabCount() const {
+    return numSlabs;
+}
+
+size_t AVLNodePool::getBlocksPerSlab() const {
+    return blocksPerSlab;
+}
+
+bool AVLNodePool::isPoolBlock(size_t bytes, size_t alignment) const {
+    return blockSize != 0 && bytes == requestBytes && alignment == requestAlign;
+}
+
+void *AVLNodePool::do_allocate(size_t bytes, size_t alignment) {
+    if (blockSize == 0 && alignment <= alignof(std::max_align_t)) {
+        // the first request decides the block size, every node is the same size
+        requestBytes = bytes;
+        requestAlign = alignment;
+        blockAlign = std::max(alignment, alignof(FreeBlock));
+        blockSize = (std::max(bytes, sizeof(FreeBlock)) + blockAlign - 1) / blockAlign * blockAlign;
+    }
+    if (!isPoolBlock(bytes, alignment)) {
+        return upstream->allocate(bytes, alignment); // not a node, let upstream handle it
+    }
+    if (freeList) {
+        // reuse a block freed earlier
+        FreeBlock *block = freeList;
+        freeList = block->next;
+        return block;
+    }
+    if (nextUnused == slabEnd) {
+        addSlab();
+    }
+    void *block = nextUnused;
+    nextUnused += blockSize;
+    return block;
+}
+
+void AVLNodePool::do_deallocate(void *p, size_t bytes, size_t alignment) {
+    if (!isPoolBlock(bytes, alignment)) {
+        upstream->deallocate(p, bytes, alignment);
+        return;
+    }
+    // push onto the free list, the memory itself stays in its slab until release()
+    FreeBlock *block = static_cast<FreeBlock *>(p);
+    block->next = freeList;
+    freeList = block;
+}
+
+bool AVLNodePool::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+void AVLNodePool::addSlab() {
+    // slab header first, then blocksPerSlab blocks starting at the next aligned offset
+    size_t headerBytes = (sizeof(Slab) + blockAlign - 1) / blockAlign * blockAlign;
+    size_t bytes = headerBytes + blockSize * blocksPerSlab;
+    Slab *slab = static_cast<Slab *>(upstream->allocate(bytes, alignof(std::max_align_t)));
+    slab->next = slabs;
+    slab->bytes = bytes;
+    slabs = slab;
+    numSlabs++;
+    nextUnused = reinterpret_cast<char *>(slab) + headerBytes;
+    slabEnd = nextUnused + blockSize * blocksPerSlab;
+}
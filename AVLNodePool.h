@@ -0,0 +1,132 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * AVLNodePool.h
+ */
+
+#ifndef AVLNODEPOOL_H
+#define AVLNODEPOOL_H
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+// Slab allocator for tree nodes. Blocks of one fixed size (set by the first
+// allocation) are carved out of large slabs and recycled through a free list;
+// any other size goes straight to the upstream resource. release() hands every
+// slab back at once, so a tree that owns its pool never frees nodes one by one.
+class AVLNodePool : public std::pmr::memory_resource {
+public:
+    static constexpr size_t defaultBlocksPerSlab = 1024;
+
+    explicit AVLNodePool(size_t blocksPerSlab = defaultBlocksPerSlab,
+                         std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+
+    AVLNodePool(const AVLNodePool &) = delete;
+
+    AVLNodePool &operator=(const AVLNodePool &) = delete;
+
+    ~AVLNodePool() override;
+
+    // frees every slab, invalidating all blocks handed out so far
+    void release();
+
+    size_t slabCount() const;
+
+    size_t getBlocksPerSlab() const;
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    struct Slab {
+        Slab *next;
+        size_t bytes;
+    };
+
+    std::pmr::memory_resource *upstream;
+    size_t blocksPerSlab;
+    size_t requestBytes; // size and alignment the pool serves
+    size_t requestAlign;
+    size_t blockSize; // requestBytes rounded up to hold a free list link
+    size_t blockAlign;
+    FreeBlock *freeList;
+    Slab *slabs;
+    size_t numSlabs;
+    char *nextUnused; // bump pointer into the newest slab
+    char *slabEnd;
+
+    bool isPoolBlock(size_t bytes, size_t alignment) const;
+
+    void addSlab();
+};
+
+// Standard allocator over a shared AVLNodePool. Copies and rebinds share the
+// pool; copying a container (select_on_container_copy_construction) starts a
+// fresh pool so the copy can be released independently of the original.
+template<typename T>
+class AVLPoolAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit AVLPoolAllocator(size_t blocksPerSlab = AVLNodePool::defaultBlocksPerSlab)
+        : pool(std::make_shared<AVLNodePool>(blocksPerSlab)) {
+    }
+
+    // moving is copying, a moved-from allocator must still be usable
+    AVLPoolAllocator(const AVLPoolAllocator &other) noexcept = default;
+
+    template<typename U>
+    AVLPoolAllocator(const AVLPoolAllocator<U> &other) noexcept : pool(other.pool) {
+    }
+
+    AVLPoolAllocator &operator=(const AVLPoolAllocator &other) noexcept = default;
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(pool->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, size_t n) {
+        pool->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    AVLPoolAllocator select_on_container_copy_construction() const {
+        return AVLPoolAllocator(pool->getBlocksPerSlab());
+    }
+
+    // true when no other allocator, and so no other container, uses this pool
+    bool soleOwner() const noexcept {
+        return pool.use_count() == 1;
+    }
+
+    AVLNodePool &getPool() const noexcept {
+        return *pool;
+    }
+
+    template<typename U>
+    bool operator==(const AVLPoolAllocator<U> &other) const noexcept {
+        return pool == other.pool;
+    }
+
+private:
+    template<typename U>
+    friend class AVLPoolAllocator;
+
+    std::shared_ptr<AVLNodePool> pool;
+};
+
+#endif //AVLNODEPOOL_H
@@ -11,122 +11,723 @@
 
 #ifndef AVLTREE_H
 #define AVLTREE_H
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <optional>
+#include <ostream>
+#include <ranges>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
+#include "AVLNodePool.h"
+#include "BinaryCodec.h"
+#include "AVLTreeStats.h"
+#include "KeyCompare.h"
 
 using namespace std;
 
+// comparators that declare is_transparent can compare Key against other types
+template<typename Compare>
+concept TransparentCompare = requires { typename Compare::is_transparent; };
+
+// Ordered map from Key to Value kept balanced as an AVL tree.
+// Compare is a strict weak ordering on keys; when it is transparent (the default
+// std::less<> is) lookups accept anything comparable with Key, such as a
+// string_view or const char* for string keys, without building a Key.
+// Allocator is rebound to allocate whole nodes.
+template<typename Key = std::string, typename Value = size_t, typename Compare = std::less<>,
+    typename Allocator = std::allocator<std::pair<const Key, Value> > >
 class AVLTree {
+protected:
+    class AVLNode;
+
+    template<bool IsConst>
+    class TreeIterator;
+
 public:
-    using KeyType = std::string;
-    using ValueType = size_t;
+    using KeyType = Key;
+    using ValueType = Value;
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+    using iterator = TreeIterator<false>;
+    using const_iterator = TreeIterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // small trivially copyable keys (integers, ids, ...) are passed and compared by value
+    using KeyParam = std::conditional_t<std::is_trivially_copyable_v<Key> && sizeof(Key) <= 2 * sizeof(void *),
+        Key, const Key &>;
 
     AVLTree();
 
-    bool insert(const std::string &key, size_t value);
+    explicit AVLTree(const Compare &comp, const Allocator &alloc = Allocator());
+
+    // nodes are allocated through alloc, e.g. an AVLPoolAllocator or a
+    // std::pmr::polymorphic_allocator over any memory_resource
+    explicit AVLTree(const Allocator &alloc);
+
+    // builds from (key, value) pairs, see buildFromSorted
+    template<std::input_iterator InputIt>
+    AVLTree(InputIt first, InputIt last, const Compare &comp = Compare(), const Allocator &alloc = Allocator());
+
+    bool insert(KeyParam key, const Value &value);
+
+    // replaces the contents with the (key, value) pairs in [first, last).
+    // Input sorted by key with no duplicates is linked straight into a perfectly
+    // balanced tree in O(n) with no comparisons against the tree and no rotations;
+    // anything else falls back to inserting one by one (first duplicate wins).
+    template<std::input_iterator InputIt>
+    void buildFromSorted(InputIt first, InputIt last);
+
+    // inserts key with a value built from args only if key is not already present,
+    // returns an iterator to the entry and whether an insertion happened
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(KeyParam key, Args &&... args);
+
+    // inserts key or overwrites the value of an existing key in a single descent
+    std::pair<iterator, bool> insert_or_assign(KeyParam key, const Value &value);
+
+    // rvalue keys are moved into the new node (a std::string key hands over its
+    // buffer) and are left untouched when the key is already present
+    bool insert(Key &&key, Value value) requires std::is_reference_v<KeyParam>;
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(Key &&key, Args &&... args) requires std::is_reference_v<KeyParam>;
+
+    std::pair<iterator, bool> insert_or_assign(Key &&key, Value value) requires std::is_reference_v<KeyParam>;
+
+    Value &operator[](Key &&key) requires std::is_reference_v<KeyParam>;
+
+    bool remove(KeyParam key);
+
+    bool contains(KeyParam key) const;
+
+    std::optional<Value> get(KeyParam key) const;
+
+    // returns the value for key, inserting a default value first if key is missing
+    Value &operator[](KeyParam key);
+
+    // heterogeneous overloads for transparent comparators, the key is compared in
+    // place and a Key is only built when operator[] has to insert it
+    template<typename K> requires TransparentCompare<Compare>
+    bool remove(const K &key);
+
+    template<typename K> requires TransparentCompare<Compare>
+    bool contains(const K &key) const;
+
+    template<typename K> requires TransparentCompare<Compare>
+    std::optional<Value> get(const K &key) const;
+
+    template<typename K> requires TransparentCompare<Compare>
+    Value &operator[](const K &key);
+
+    // in-order traversal built on the parent links: iterators stay valid until
+    // the entry they point at is erased, and ++/-- are amortized O(1)
+    iterator begin();
+
+    const_iterator begin() const;
+
+    iterator end();
+
+    const_iterator end() const;
+
+    const_iterator cbegin() const;
+
+    const_iterator cend() const;
+
+    reverse_iterator rbegin();
+
+    const_reverse_iterator rbegin() const;
+
+    reverse_iterator rend();
+
+    const_reverse_iterator rend() const;
+
+    iterator find(KeyParam key);
+
+    const_iterator find(KeyParam key) const;
+
+    // first entry whose key is not less than key
+    iterator lower_bound(KeyParam key);
+
+    const_iterator lower_bound(KeyParam key) const;
+
+    // first entry whose key is greater than key
+    iterator upper_bound(KeyParam key);
+
+    const_iterator upper_bound(KeyParam key) const;
+
+    std::pair<iterator, iterator> equal_range(KeyParam key);
+
+    std::pair<const_iterator, const_iterator> equal_range(KeyParam key) const;
+
+    template<typename K> requires TransparentCompare<Compare>
+    iterator find(const K &key);
+
+    template<typename K> requires TransparentCompare<Compare>
+    const_iterator find(const K &key) const;
 
-    bool remove(const std::string &key);
+    template<typename K> requires TransparentCompare<Compare>
+    iterator lower_bound(const K &key);
 
-    bool contains(const std::string &key) const;
+    template<typename K> requires TransparentCompare<Compare>
+    const_iterator lower_bound(const K &key) const;
 
-    std::optional<size_t> get(const std::string &key) const;
+    template<typename K> requires TransparentCompare<Compare>
+    iterator upper_bound(const K &key);
 
-    size_t &operator[](const std::string &key);
+    template<typename K> requires TransparentCompare<Compare>
+    const_iterator upper_bound(const K &key) const;
 
-    vector<std::string> findRange(const std::string &lowKey, const std::string &highKey);
+    template<typename K> requires TransparentCompare<Compare>
+    std::pair<iterator, iterator> equal_range(const K &key);
 
-    std::vector<std::string> keys() const;
+    template<typename K> requires TransparentCompare<Compare>
+    std::pair<const_iterator, const_iterator> equal_range(const K &key) const;
+
+    // Hinted lookups and inserts start at hint instead of the root: they climb
+    // hint's parent links only until the subtree there covers key, then walk
+    // down, so a key d positions from hint costs O(log d) comparisons. end()
+    // as the hint starts at the largest key, the usual spot for appends.
+    iterator find(const_iterator hint, KeyParam key);
+
+    const_iterator find(const_iterator hint, KeyParam key) const;
+
+    template<typename K> requires TransparentCompare<Compare>
+    iterator find(const_iterator hint, const K &key);
+
+    template<typename K> requires TransparentCompare<Compare>
+    const_iterator find(const_iterator hint, const K &key) const;
+
+    // inserts unless key is already present, returns the entry for key either way
+    iterator insert(const_iterator hint, KeyParam key, const Value &value);
+
+    // With finger search on, every lookup, insert and remove is hinted with the
+    // node the previous one touched, which makes sorted and near-sorted access
+    // close to O(1) per operation. Random access pays for a climb on top of the
+    // descent, so it is off by default.
+    void setFingerSearch(bool enabled);
+
+    bool fingerSearch() const;
+
+    // subtrees smaller than this are never split across threads
+    static constexpr size_t parallelCutoff = size_t(1) << 15;
+
+    // Copying, clearing/destroying and bulk building from random-access input
+    // fork the two halves of large subtrees onto separate threads. This needs an
+    // allocator that any thread may use, i.e. a stateless one like std::allocator;
+    // pooled and polymorphic allocators always run on the calling thread.
+    static constexpr bool parallelAllocation = std::allocator_traits<Allocator>::is_always_equal::value &&
+                                               std::is_empty_v<Allocator>;
+
+    // Batch operations sort the batch internally and walk the tree once for all
+    // of it instead of descending from the root per key. Results are returned in
+    // the caller's order. The elements of keys may be any type the comparator
+    // accepts (Key, or string_view etc. when it is transparent).
+    template<std::ranges::random_access_range Keys>
+    std::vector<std::optional<Value> > getBatch(const Keys &keys) const;
+
+    template<std::ranges::random_access_range Keys>
+    std::vector<bool> containsBatch(const Keys &keys) const;
+
+    // inserts a batch of (key, value) pairs, each descent starting from the
+    // previous insertion point; duplicates keep the earliest entry in the batch.
+    // returns the number of keys inserted
+    template<std::ranges::random_access_range Entries>
+    size_t insertBatch(const Entries &entries);
+
+    // number of keys less than key, O(log n)
+    size_t rank(KeyParam key) const;
+
+    // the entry at 0-based position k in sorted order, end() if k >= size(), O(log n)
+    iterator select(size_t k);
+
+    const_iterator select(size_t k) const;
+
+    // number of keys in [lowKey, highKey] without visiting them, O(log n)
+    size_t countRange(KeyParam lowKey, KeyParam highKey) const;
+
+    template<typename K> requires TransparentCompare<Compare>
+    size_t rank(const K &key) const;
+
+    template<typename K> requires TransparentCompare<Compare>
+    size_t countRange(const K &lowKey, const K &highKey) const;
+
+    // removes the entry at pos, returns an iterator to the entry after it
+    iterator erase(const_iterator pos);
+
+    // Moves every entry whose key is not less than key into the returned tree,
+    // which shares this tree's comparator, allocator and finger search
+    // setting. O(log n): subtrees are relinked, never copied or reallocated.
+    // If the comparator throws, the tree is left as it was.
+    AVLTree split(KeyParam key);
+
+    template<typename K> requires TransparentCompare<Compare>
+    AVLTree split(const K &key);
+
+    // Appends other's entries, all of which must order after every key here, in
+    // O(log n) and leaves other empty; throws std::invalid_argument if they
+    // overlap. Trees whose allocators differ fall back to moving entry by entry.
+    void join(AVLTree &other);
+
+    // Removes every entry with a key in [lowKey, highKey] and returns how many:
+    // two splits and a join, O(log n), plus O(k) to free the k entries. If the
+    // comparator throws, every entry is kept.
+    size_t eraseRange(KeyParam lowKey, KeyParam highKey);
+
+    template<typename K> requires TransparentCompare<Compare>
+    size_t eraseRange(const K &lowKey, const K &highKey);
+
+    // Set operations by key that consume other, leaving it empty. Each splits
+    // other at this tree's top key and recurses on both halves, joining the
+    // results, so for sizes m <= n they take O(m log(n/m + 1)) and the result
+    // comes out balanced. Nodes are relinked, never copied; large halves are
+    // combined on separate threads like copies and bulk builds are. If the
+    // comparator throws midway, both trees are left empty with every node freed.
+
+    // adds other's entries whose keys are missing here; shared keys keep this
+    // tree's value. Trees whose allocators differ fall back to moving entry by entry
+    void unionWith(AVLTree &other);
+
+    // keeps only the entries whose keys are also in other
+    void intersect(AVLTree &other);
+
+    // removes the entries whose keys are in other
+    void difference(AVLTree &other);
+
+    // copies of every key in [lowKey, highKey], in order
+    vector<Key> findRange(const Key &lowKey, const Key &highKey) const;
+
+    // lazy view over the entries with keys in [lowKey, highKey]; nothing is copied
+    // or allocated, and it composes with std::views::reverse, take, drop, ...
+    std::ranges::subrange<iterator> range(KeyParam lowKey, KeyParam highKey);
+
+    std::ranges::subrange<const_iterator> range(KeyParam lowKey, KeyParam highKey) const;
+
+    // calls visit(key, value) for entries with keys in [lowKey, highKey], in
+    // ascending order or descending when reverse is set, stopping after limit
+    // entries or when visit returns false; O(log n + k), no allocation
+    template<typename Visitor>
+    size_t forEachInRange(KeyParam lowKey, KeyParam highKey, Visitor &&visit,
+                          size_t limit = std::numeric_limits<size_t>::max(), bool reverse = false) const;
+
+    // all keys in sorted order
+    std::vector<Key> keys() const;
 
     size_t size() const;
 
-    size_t getHeight();
+    bool empty() const;
+
+    // removes every key, keeping the tree's allocator
+    void clear();
+
+    // O(1), read from the root's stored height
+    size_t getHeight() const;
+
+    // O(n) structural check for tests and debugging: keys strictly increasing,
+    // parent links, stored heights and subtree sizes, AVL balance and size().
+    // Throws std::logic_error naming the first broken invariant
+    void verify() const;
+
+    allocator_type get_allocator() const;
+
+    // Writes every entry in sorted order in a compact binary format (see
+    // BinaryCodec.h for how keys and values are encoded). The file is written
+    // next to path and renamed over it, so path never holds a partial file.
+    void save(const std::string &path) const requires BinarySerializable<Key> && BinarySerializable<Value>;
+
+    void save(std::ostream &out) const requires BinarySerializable<Key> && BinarySerializable<Value>;
+
+    // Replaces the contents with what save wrote, linking entries into a
+    // balanced tree as they are read: O(n), no comparisons beyond checking the
+    // order and no rotations. Throws std::runtime_error on a missing, truncated
+    // or corrupt file, leaving the tree as it was.
+    void load(const std::string &path) requires BinarySerializable<Key> && BinarySerializable<Value>;
+
+    void load(std::istream &in) requires BinarySerializable<Key> && BinarySerializable<Value>;
+
+#if AVLTREE_STATS
+    // counters and latencies since construction or the last resetStats()
+    const AVLTreeStats &stats() const { return treeStats; }
+
+    void resetStats() { treeStats.reset(); }
+#endif
 
     AVLTree(const AVLTree &other);
 
+    // O(1), other is left empty
+    AVLTree(AVLTree &&other) noexcept;
+
     ~AVLTree();
 
-    void operator=(const AVLTree &other);
+    // strong guarantee: if copying throws, this tree is unchanged
+    AVLTree &operator=(const AVLTree &other);
+
+    // O(1) when the allocator propagates or compares equal, otherwise copies
+    AVLTree &operator=(AVLTree &&other) noexcept(NodeTraits::propagate_on_container_move_assignment::value ||
+                                                 NodeTraits::is_always_equal::value);
+
+    // O(1), exchanges the nodes of the two trees
+    void swap(AVLTree &other) noexcept;
+
+    friend void swap(AVLTree &a, AVLTree &b) noexcept {
+        a.swap(b);
+    }
 
 
-    friend std::ostream &operator<<(ostream &os, const AVLTree &avlTree);
+    friend std::ostream &operator<<(ostream &os, const AVLTree &avlTree) {
+        avlTree.printTree(avlTree.root, os, 0); // call printTree helper to print the tree
+        return os;
+    }
 
 protected:
     class AVLNode {
     public:
-        KeyType key;
-        ValueType value;
-        size_t height;
-
-        int balance;
-
+        value_type entry; // key and value together, this is what iterators point at
+        // height of the subtree rooted here (leaf = 0), kept up to date by every
+        // insert, erase and rotation; an AVL tree over 2^64 keys is under 93 tall,
+        // so one byte is plenty and the balance factor is read off the two children
+        std::uint8_t height;
 
         AVLNode *left;
         AVLNode *right;
         AVLNode *parent;
 
-        AVLNode(KeyType key, ValueType value) : key(std::move(key)), value(value), height(0), balance(0), left(nullptr),
-                                                right(nullptr), parent(nullptr) {
+        // number of nodes in the subtree rooted here, for rank/select
+        size_t subtreeSize;
+
+        template<typename K, typename... Args>
+        AVLNode(K &&key, Args &&... args) : entry(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                                                  std::forward_as_tuple(std::forward<Args>(args)...)),
+                                            height(0), left(nullptr), right(nullptr), parent(nullptr),
+                                            subtreeSize(1) {
         }
 
+        const KeyType &key() const { return entry.first; }
+
+        ValueType &value() { return entry.second; }
+
+        const ValueType &value() const { return entry.second; }
+
         // 0, 1 or 2
         size_t numChildren() const;
 
         // true or false
         bool isLeaf() const;
 
-        size_t getHeight();
+        size_t getHeight() const;
+
+        // child pointer on one side, false for left and true for right
+        AVLNode *&child(bool rightSide) { return rightSide ? right : left; }
     };
 
+    template<bool IsConst>
+    class TreeIterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using iterator_concept = std::bidirectional_iterator_tag;
+        using value_type = AVLTree::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, const value_type &, value_type &>;
+        using pointer = std::conditional_t<IsConst, const value_type *, value_type *>;
+
+        TreeIterator() = default;
+
+        // iterator converts to const_iterator
+        template<bool OtherConst> requires (IsConst && !OtherConst)
+        TreeIterator(const TreeIterator<OtherConst> &other) : node(other.node), tree(other.tree) {
+        }
+
+        reference operator*() const { return node->entry; }
+
+        pointer operator->() const { return &node->entry; }
+
+        TreeIterator &operator++() {
+            node = nextNode(node);
+            return *this;
+        }
+
+        TreeIterator operator++(int) {
+            TreeIterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        TreeIterator &operator--() {
+            // stepping back from end() lands on the largest key
+            node = node ? prevNode(node) : maxNode(tree->root);
+            return *this;
+        }
+
+        TreeIterator operator--(int) {
+            TreeIterator old = *this;
+            --*this;
+            return old;
+        }
+
+        friend bool operator==(const TreeIterator &a, const TreeIterator &b) { return a.node == b.node; }
+
+    private:
+        friend class AVLTree;
+        friend class TreeIterator<!IsConst>;
+
+        AVLNode *node = nullptr; // nullptr is end()
+        const AVLTree *tree = nullptr; // needed to step back from end()
+
+        TreeIterator(AVLNode *node, const AVLTree *tree) : node(node), tree(tree) {
+        }
+    };
+
+    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<AVLNode>;
+    using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+    // in-order neighbours and extremes, nullptr when there is none
+    static AVLNode *nextNode(AVLNode *node);
+
+    static AVLNode *prevNode(AVLNode *node);
+
+    static AVLNode *minNode(AVLNode *node);
+
+    static AVLNode *maxNode(AVLNode *node);
+
 public:
 
 
 private:
     AVLNode *root;
     size_t treeSize;
+    [[no_unique_address]] Compare comp;
+    [[no_unique_address]] NodeAllocator nodeAlloc;
+#if AVLTREE_STATS
+    mutable AVLTreeStats treeStats; // updated by const lookups too
+#endif
+    // the last node accessed while finger search is on; moved by const
+    // lookups too, through relaxed atomic_refs so concurrent readers don't race
+    mutable AVLNode *finger = nullptr;
+    bool fingerEnabled = false;
+
+    AVLNode *fingerNode() const;
+
+    // points the finger at node when finger search is on
+    void moveFinger(AVLNode *node) const;
+
+    // where a search for key should begin: near itself climbed toward key, or
+    // the root when near is null
+    template<typename K>
+    AVLNode *searchStart(AVLNode *near, const K &key) const;
+
+    // the node hint refers to, the largest node for end()
+    AVLNode *hintNode(const_iterator hint) const;
 
-    /* Helper methods for remove */
-    // this overloaded remove will do the recursion to remove the node
-    bool remove(AVLNode *&current, KeyType key);
+    // descent from start, which must cover key; last is the final node visited
+    template<typename K>
+    AVLNode *findNodeFrom(AVLNode *start, const K &key, AVLNode *&last) const;
 
-    // removeNode contains the logic for actually removing a node based on the number of children
-    bool removeNode(AVLNode *&current);
+    // allocates a node through nodeAlloc and constructs it from key and value arguments
+    template<typename K, typename... Args>
+    AVLNode *createNode(K &&key, Args &&... args);
 
-    // You will implement this, but it is needed for removeNode()
-    void balanceNode(AVLNode *&node);
+    // destroys a node and returns its memory to nodeAlloc
+    void destroyNode(AVLNode *node);
 
-    bool contains(AVLNode *current, KeyType key) const;
+    // unlinks node, puts its successor (if any) in its place, frees it and rebalances
+    void removeNode(AVLNode *node);
 
-    void insertRecursive(AVLNode *&parent, AVLNode *&nodeToInsert);
+    // updates node's height and rotates if it is out of balance, returns the subtree root
+    AVLNode *balanceNode(AVLNode *node);
 
-    std::optional<size_t> get(AVLNode *current, KeyType Key) const;
+    // walks up parent links from node rebalancing, stops once a subtree height is unchanged
+    void retrace(AVLNode *node);
 
-    size_t &getValue(AVLNode *&current, KeyType key);
+    // iterative search, returns the node holding key or nullptr
+    template<typename K>
+    AVLNode *findNode(const K &key) const;
 
-    void findKeysInRange(AVLNode *current, const std::string &lowKey, const std::string &highKey, vector<string> &keys);
+    // shared body of try_emplace and operator[], key is forwarded into a new node
+    template<typename KeyArg, typename... Args>
+    std::pair<iterator, bool> emplaceUnique(KeyArg &&key, Args &&... args);
 
-    void allKeys(AVLNode *current, vector<string> &keys) const;
+    // takes other's nodes, this tree must already be empty
+    void stealNodes(AVLTree &other) noexcept;
 
-    void deleteTree(AVLNode *current);
+    // walks down once looking for key, returns the node holding it or nullptr with
+    // parent/goRight describing where a new node for key should be attached
+    template<typename K>
+    AVLNode *findInsertPosition(const K &key, AVLNode *&parent, bool &goRight) const;
 
-    static size_t getHeightHelper(AVLNode *current);
+    // builds a balanced subtree from the next count entries of it, in order;
+    // heights, sizes and parent links come out right without any rebalancing
+    template<typename It>
+    AVLNode *buildBalanced(It &it, size_t count);
 
-    AVLNode *copyTree(const AVLNode *current);
+    // feeds the entries of a saved file to buildBalanced, checking their order
+    class SavedEntryReader;
+
+    // first bytes of a file written by save
+    static constexpr char savedMagic[8] = {'A', 'V', 'L', 'T', 'R', 'E', 'E', '1'};
+
+    // random-access version of buildBalanced, forks while forkDepth > 0
+    template<typename RandomIt>
+    AVLNode *buildBalancedRange(RandomIt first, size_t count, int forkDepth);
+
+    // how many levels of subtree splits go to new threads, 0 when running serially
+    static int parallelForkDepth();
+
+    // runs buildLeft on another thread when fork is set and buildRight on this one;
+    // if either throws, whatever the other built is freed before rethrowing
+    template<typename LeftFn, typename RightFn>
+    std::pair<AVLNode *, AVLNode *> forkJoin(bool fork, LeftFn buildLeft, RightFn buildRight);
+
+    // like findInsertPosition, but descends from start instead of the root;
+    // key must fall inside the key range start's subtree covers
+    template<typename K>
+    AVLNode *findInsertPositionFrom(AVLNode *start, const K &key, AVLNode *&parent, bool &goRight) const;
+
+    // climbs from node to the lowest ancestor whose subtree range holds key,
+    // O(log d) for a key d positions away from node
+    template<typename K>
+    AVLNode *climbToward(AVLNode *node, const K &key) const;
+
+    // visits (index, node) for every batch key found in node's subtree;
+    // [first, last) are batch indices sorted by key
+    template<typename Keys, typename Visit>
+    void batchWalk(AVLNode *node, const Keys &keys, const size_t *first, const size_t *last, Visit &visit) const;
+
+    // batch indices sorted by key, ties kept in input order
+    template<typename Keys, typename KeyOf>
+    std::vector<size_t> sortedBatchOrder(const Keys &items, KeyOf keyOf) const;
+
+    static void prefetchNode(const AVLNode *node);
+
+    // links newNode under parent and rebalances back up to the root
+    void attachNode(AVLNode *newNode, AVLNode *parent, bool goRight);
+
+    template<typename K>
+    bool removeKey(const K &key);
+
+    // The split/join helpers work on detached subtrees (null parent at the top)
+    // and return the new top. A rotation at a top node repoints root, so callers
+    // treat root as scratch until they store the final result in it.
+
+    // joins left, middle and right, whose keys are in that order, into one subtree
+    AVLNode *joinNodes(AVLNode *left, AVLNode *middle, AVLNode *right);
+
+    // joins left and right, whose keys are in that order, into one subtree
+    AVLNode *joinTrees(AVLNode *left, AVLNode *right);
+
+    // splits node's subtree into keys below the search key of order and the
+    // rest; with inclusive set a key equal to it goes below instead
+    template<typename K>
+    std::pair<AVLNode *, AVLNode *> splitNodes(AVLNode *node, KeyDescent<Key, Compare, K> &order, bool inclusive);
+
+    // unlinks the largest node of node's subtree into last, returns what is left
+    AVLNode *splitLast(AVLNode *node, AVLNode *&last);
+
+    // clears node's child and parent links, returns the former children as
+    // detached subtrees
+    static std::pair<AVLNode *, AVLNode *> detachChildren(AVLNode *node);
+
+    static int heightOf(const AVLNode *node);
+
+    // like splitNodes, but a node equal to the search key is detached into
+    // match and goes to neither side
+    template<typename K>
+    std::pair<AVLNode *, AVLNode *> splitAround(AVLNode *node, KeyDescent<Key, Compare, K> &order, AVLNode *&match);
+
+    enum class SetOp {
+        unite, intersect, subtract
+    };
+
+    // runs op on this tree and other, which ends up empty
+    void combineWith(SetOp op, AVLTree &other);
+
+    // op on detached subtrees: mine holds this tree's nodes and theirs source's
+    // (possibly this tree itself). This tree joins and frees mine and source
+    // splits and frees theirs, so their allocators may differ
+    AVLNode *combineNodes(SetOp op, AVLNode *mine, AVLNode *theirs, AVLTree &source, int forkDepth);
+
+    template<typename K>
+    AVLTree splitAt(const K &key);
+
+    template<typename K>
+    size_t eraseKeyRange(const K &lowKey, const K &highKey);
+
+    template<typename K>
+    AVLNode *lowerBoundNode(const K &key) const;
+
+    template<typename K>
+    AVLNode *upperBoundNode(const K &key) const;
+
+    // number of keys below key, or at most key when inclusive is set
+    template<typename K>
+    size_t countBelow(const K &key, bool inclusive) const;
+
+    AVLNode *selectNode(size_t k) const;
+
+    // adds delta to the subtree size of node and every ancestor
+    void adjustSizesToRoot(AVLNode *node, std::ptrdiff_t delta);
+
+    template<typename K>
+    Value &findOrInsertDefault(const K &key);
+
+    void deleteTree(AVLNode *current, int forkDepth = 0);
+
+    // runs node destructors only, used before a pool releases its slabs
+    void destroyKeys(AVLNode *current);
+
+    AVLNode *copyTree(const AVLNode *current, int forkDepth = 0);
 
     void printTree(AVLNode *current, std::ostream &os, int depth) const;
 
-    bool setChild(AVLNode *parent, const std::string &whichChild, AVLNode *child);
+    // verify() for node's subtree, whose keys must lie strictly between low and
+    // high where those are set; returns the number of nodes checked
+    size_t verifyNode(const AVLNode *node, const AVLNode *parent, const AVLNode *low, const AVLNode *high) const;
 
-    bool replaceChild(AVLNode *parent, AVLNode *currentChild, AVLNode *newChild);
+    void setChild(AVLNode *parent, bool rightSide, AVLNode *child);
+
+    // reference to the pointer that points at node (root or a child slot of its parent)
+    AVLNode *&parentLink(AVLNode *node);
 
     void updateHeight(AVLNode *current);
 
+    static size_t sizeOf(const AVLNode *node);
+
+    void updateSize(AVLNode *current);
+
     int getBalance(AVLNode *current);
 
+    AVLNode *rotate(AVLNode *current, bool rightChildUp);
+
     AVLNode *rotateRight(AVLNode *current);
 
     AVLNode *rotateLeft(AVLNode *current);
 };
 
+// tree whose nodes come from a slab pool it owns, so clear() and destruction
+// hand whole slabs back instead of freeing node by node
+template<typename Key = std::string, typename Value = size_t, typename Compare = std::less<> >
+using PooledAVLTree = AVLTree<Key, Value, Compare, AVLPoolAllocator<std::pair<const Key, Value> > >;
+
+#include "AVLTree.tpp"
+
+// the default string -> size_t tree is compiled once in AVLTree.cpp
+extern template class AVLTree<std::string, size_t>;
+
 #endif //AVLTREE_H
@@ -0,0 +1,1966 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * AVLTree.tpp
+ * Member definitions for AVLTree, included at the bottom of AVLTree.h.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+bool AVLTree<Key, Value, Compare, Allocator>::insert(KeyParam key, const Value &value) {
+    AVLTREE_TIME(insertLatency);
+    // insert key-value pair into AVL tree, false if the key already exists
+    return try_emplace(key, value).second;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<std::input_iterator InputIt>
+void AVLTree<Key, Value, Compare, Allocator>::buildFromSorted(InputIt first, InputIt last) {
+    if constexpr (!std::forward_iterator<InputIt>) {
+        // single pass input, buffer it so it can be checked and then linked
+        std::vector<std::pair<Key, Value> > buffer(first, last);
+        buildFromSorted(buffer.begin(), buffer.end());
+    } else {
+        clear();
+        // one pass to count and make sure the keys are strictly increasing
+        size_t count = 0;
+        bool sorted = true;
+        for (InputIt it = first, previous = first; it != last; previous = it, ++it, ++count) {
+            if (count > 0 && !comp(previous->first, it->first)) {
+                sorted = false;
+                break;
+            }
+        }
+        if (!sorted) {
+            for (; first != last; ++first) {
+                try_emplace(first->first, first->second);
+            }
+            return;
+        }
+        if constexpr (std::random_access_iterator<InputIt>) {
+            root = buildBalancedRange(first, count, parallelForkDepth());
+        } else {
+            root = buildBalanced(first, count);
+        }
+        treeSize = count;
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename It>
+auto AVLTree<Key, Value, Compare, Allocator>::buildBalanced(It &it, size_t count) -> AVLNode * {
+    if (count == 0) {
+        return nullptr;
+    }
+    // the middle entry is the root, halves differ by at most one node so the
+    // subtree heights differ by at most one as well
+    size_t leftCount = count / 2;
+    AVLNode *left = buildBalanced(it, leftCount);
+    AVLNode *node = nullptr;
+    try {
+        node = createNode(it->first, it->second);
+        ++it;
+        setChild(node, false, left);
+        setChild(node, true, buildBalanced(it, count - leftCount - 1));
+    } catch (...) {
+        // free what this call built, the callers free the rest
+        if (node) {
+            node->left = nullptr;
+            destroyNode(node);
+        }
+        deleteTree(left);
+        throw;
+    }
+    updateHeight(node);
+    node->subtreeSize = count;
+    return node;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename RandomIt>
+auto AVLTree<Key, Value, Compare, Allocator>::buildBalancedRange(RandomIt first, size_t count,
+                                                                  int forkDepth) -> AVLNode * {
+    if (count == 0) {
+        return nullptr;
+    }
+    size_t leftCount = count / 2;
+    RandomIt middle = first + leftCount;
+    AVLNode *node = createNode(middle->first, middle->second);
+    try {
+        // the halves are independent ranges of the input, so they can be built concurrently
+        auto [left, right] = forkJoin(forkDepth > 0 && count >= parallelCutoff,
+                                      [&] { return buildBalancedRange(first, leftCount, forkDepth - 1); },
+                                      [&] {
+                                          return buildBalancedRange(middle + 1, count - leftCount - 1,
+                                                                    forkDepth - 1);
+                                      });
+        setChild(node, false, left);
+        setChild(node, true, right);
+    } catch (...) {
+        destroyNode(node);
+        throw;
+    }
+    updateHeight(node);
+    node->subtreeSize = count;
+    return node;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+int AVLTree<Key, Value, Compare, Allocator>::parallelForkDepth() {
+    if constexpr (!parallelAllocation) {
+        return 0;
+    } else {
+        unsigned threads = std::thread::hardware_concurrency();
+        if (threads <= 1) {
+            return 0;
+        }
+        // one level more than needed to cover every core, so uneven halves still keep cores busy
+        return std::bit_width(threads);
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename LeftFn, typename RightFn>
+auto AVLTree<Key, Value, Compare, Allocator>::forkJoin(bool fork, LeftFn buildLeft, RightFn buildRight)
+    -> std::pair<AVLNode *, AVLNode *> {
+    if (!fork) {
+        AVLNode *left = buildLeft();
+        try {
+            return {left, buildRight()};
+        } catch (...) {
+            deleteTree(left);
+            throw;
+        }
+    }
+    std::future<AVLNode *> leftResult;
+    try {
+        leftResult = std::async(std::launch::async, buildLeft);
+    } catch (const std::system_error &) {
+        return forkJoin(false, buildLeft, buildRight); // no thread to spare, build both here
+    }
+    AVLNode *right;
+    try {
+        right = buildRight();
+    } catch (...) {
+        try {
+            deleteTree(leftResult.get()); // wait for the other half, then drop it
+        } catch (...) {
+        }
+        throw;
+    }
+    try {
+        return {leftResult.get(), right};
+    } catch (...) {
+        deleteTree(right);
+        throw;
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename... Args>
+auto AVLTree<Key, Value, Compare, Allocator>::try_emplace(KeyParam key, Args &&... args) -> std::pair<iterator, bool> {
+    return emplaceUnique(key, std::forward<Args>(args)...);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename KeyArg, typename... Args>
+auto AVLTree<Key, Value, Compare, Allocator>::emplaceUnique(KeyArg &&key, Args &&... args)
+    -> std::pair<iterator, bool> {
+    AVLNode *parent = nullptr;
+    bool goRight = false;
+    if (AVLNode *existing = findInsertPosition(key, parent, goRight)) {
+        return {iterator(existing, this), false}; // key already present, leave the value alone
+    }
+    AVLNode *newNode = createNode(std::forward<KeyArg>(key), std::forward<Args>(args)...);
+    attachNode(newNode, parent, goRight);
+    return {iterator(newNode, this), true};
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::insert_or_assign(KeyParam key, const Value &value)
+    -> std::pair<iterator, bool> {
+    auto result = try_emplace(key, value);
+    if (!result.second) {
+        // key was already there, overwrite the value in place
+        result.first->second = value;
+    }
+    return result;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+bool AVLTree<Key, Value, Compare, Allocator>::insert(Key &&key, Value value) requires std::is_reference_v<KeyParam> {
+    AVLTREE_TIME(insertLatency);
+    return emplaceUnique(std::move(key), std::move(value)).second;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename... Args>
+auto AVLTree<Key, Value, Compare, Allocator>::try_emplace(Key &&key, Args &&... args)
+    -> std::pair<iterator, bool> requires std::is_reference_v<KeyParam> {
+    return emplaceUnique(std::move(key), std::forward<Args>(args)...);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::insert_or_assign(Key &&key, Value value)
+    -> std::pair<iterator, bool> requires std::is_reference_v<KeyParam> {
+    AVLNode *parent = nullptr;
+    bool goRight = false;
+    if (AVLNode *existing = findInsertPosition(key, parent, goRight)) {
+        existing->value() = std::move(value);
+        return {iterator(existing, this), false};
+    }
+    AVLNode *newNode = createNode(std::move(key), std::move(value));
+    attachNode(newNode, parent, goRight);
+    return {iterator(newNode, this), true};
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+Value &AVLTree<Key, Value, Compare, Allocator>::operator[](Key &&key) requires std::is_reference_v<KeyParam> {
+    return emplaceUnique(std::move(key)).first->second;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+auto AVLTree<Key, Value, Compare, Allocator>::findInsertPosition(const K &key, AVLNode *&parent,
+                                                                  bool &goRight) const -> AVLNode * {
+    AVLNode *existing = findInsertPositionFrom(searchStart(fingerNode(), key), key, parent, goRight);
+    if (existing) {
+        moveFinger(existing); // a new node takes the finger in attachNode
+    }
+    return existing;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+auto AVLTree<Key, Value, Compare, Allocator>::findInsertPositionFrom(AVLNode *start, const K &key, AVLNode *&parent,
+                                                                      bool &goRight) const -> AVLNode * {
+    parent = start ? start->parent : nullptr;
+    goRight = parent && parent->right == start;
+    AVLNode *current = start;
+    KeyDescent<Key, Compare, K> order(comp, key);
+    while (current) {
+        AVLTREE_COUNT(comparisons);
+        int side = order(current->key());
+        if (side == 0) {
+            return current; // key found, nothing to attach
+        }
+        goRight = side > 0;
+        parent = current; // remember the last node we passed
+        current = current->child(goRight);
+    }
+    return nullptr;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+auto AVLTree<Key, Value, Compare, Allocator>::climbToward(AVLNode *node, const K &key) const -> AVLNode * {
+    if (!comp(node->key(), key) && !comp(key, node->key())) {
+        return node; // already there
+    }
+    // node's subtree is bounded by the ancestors it hangs under: going toward
+    // larger keys only a left-child link can cap the range, and vice versa.
+    // Links of the other kind leave the bound unchanged, so the lowest subtree
+    // covering key starts right above the last capping link key passed
+    bool towardLarger = comp(node->key(), key);
+    AVLNode *lowest = node;
+    while (node->parent) {
+        AVLNode *parent = node->parent;
+        if ((parent->left == node) == towardLarger) {
+            if (towardLarger ? comp(key, parent->key()) : comp(parent->key(), key)) {
+                break; // parent's key bounds the range on key's side
+            }
+            lowest = parent;
+        }
+        node = parent;
+    }
+    return lowest;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::prefetchNode(const AVLNode *node) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (node) {
+        __builtin_prefetch(node);
+    }
+#else
+    (void) node;
+#endif
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename Keys, typename KeyOf>
+std::vector<size_t> AVLTree<Key, Value, Compare, Allocator>::sortedBatchOrder(const Keys &items, KeyOf keyOf) const {
+    std::vector<size_t> order(std::ranges::size(items));
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return comp(keyOf(std::ranges::begin(items)[a]), keyOf(std::ranges::begin(items)[b]));
+    });
+    return order;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename Keys, typename Visit>
+void AVLTree<Key, Value, Compare, Allocator>::batchWalk(AVLNode *node, const Keys &keys, const size_t *first,
+                                                        const size_t *last, Visit &visit) const {
+    while (node && first != last) {
+        // fetch both children while this node's key splits the batch
+        prefetchNode(node->left);
+        prefetchNode(node->right);
+        auto keyAt = [&keys](size_t i) -> decltype(auto) { return std::ranges::begin(keys)[i]; };
+        const size_t *equalBegin = std::partition_point(first, last, [&](size_t i) {
+            return comp(keyAt(i), node->key());
+        });
+        const size_t *equalEnd = std::partition_point(equalBegin, last, [&](size_t i) {
+            return !comp(node->key(), keyAt(i));
+        });
+        for (const size_t *i = equalBegin; i != equalEnd; ++i) {
+            visit(*i, node);
+        }
+        // recurse on the smaller keys, loop on the larger ones
+        batchWalk(node->left, keys, first, equalBegin, visit);
+        node = node->right;
+        first = equalEnd;
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<std::ranges::random_access_range Keys>
+auto AVLTree<Key, Value, Compare, Allocator>::getBatch(const Keys &keys) const -> std::vector<std::optional<Value> > {
+    std::vector<std::optional<Value> > results(std::ranges::size(keys));
+    std::vector<size_t> order = sortedBatchOrder(keys, [](const auto &key) -> const auto & { return key; });
+    auto visit = [&results](size_t i, AVLNode *node) { results[i] = node->value(); };
+    batchWalk(root, keys, order.data(), order.data() + order.size(), visit);
+    return results;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<std::ranges::random_access_range Keys>
+std::vector<bool> AVLTree<Key, Value, Compare, Allocator>::containsBatch(const Keys &keys) const {
+    std::vector<bool> results(std::ranges::size(keys), false);
+    std::vector<size_t> order = sortedBatchOrder(keys, [](const auto &key) -> const auto & { return key; });
+    auto visit = [&results](size_t i, AVLNode *) { results[i] = true; };
+    batchWalk(root, keys, order.data(), order.data() + order.size(), visit);
+    return results;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<std::ranges::random_access_range Entries>
+size_t AVLTree<Key, Value, Compare, Allocator>::insertBatch(const Entries &entries) {
+    std::vector<size_t> order = sortedBatchOrder(entries, [](const auto &entry) -> const auto & {
+        return entry.first;
+    });
+    size_t inserted = 0;
+    AVLNode *previous = nullptr; // where the last key of the batch went
+    for (size_t i : order) {
+        const auto &entry = std::ranges::begin(entries)[i];
+        AVLNode *start = previous ? climbToward(previous, entry.first) : root;
+        AVLNode *parent = nullptr;
+        bool goRight = false;
+        AVLNode *node = findInsertPositionFrom(start, entry.first, parent, goRight);
+        if (!node) {
+            node = createNode(entry.first, entry.second);
+            attachNode(node, parent, goRight);
+            inserted++;
+        }
+        previous = node;
+    }
+    return inserted;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+auto AVLTree<Key, Value, Compare, Allocator>::findNode(const K &key) const -> AVLNode * {
+    AVLNode *last = nullptr;
+    AVLNode *found = findNodeFrom(searchStart(fingerNode(), key), key, last);
+    moveFinger(found ? found : last);
+    return found;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+auto AVLTree<Key, Value, Compare, Allocator>::findNodeFrom(AVLNode *start, const K &key,
+                                                           AVLNode *&last) const -> AVLNode * {
+    AVLNode *current = start;
+    KeyDescent<Key, Compare, K> order(comp, key); // one three-way compare per node
+    while (current) {
+        AVLTREE_COUNT(comparisons);
+        last = current;
+        int side = order(current->key());
+        if (side == 0) {
+            return current;
+        }
+        current = current->child(side > 0);
+    }
+    return nullptr; // key is not in the tree
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::fingerNode() const -> AVLNode * {
+    if (!fingerEnabled) {
+        return nullptr;
+    }
+    return std::atomic_ref<AVLNode *>(finger).load(std::memory_order_relaxed);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::moveFinger(AVLNode *node) const {
+    if (fingerEnabled) {
+        std::atomic_ref<AVLNode *>(finger).store(node, std::memory_order_relaxed);
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+auto AVLTree<Key, Value, Compare, Allocator>::searchStart(AVLNode *near, const K &key) const -> AVLNode * {
+    return near ? climbToward(near, key) : root;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::hintNode(const_iterator hint) const -> AVLNode * {
+    return hint.node ? hint.node : maxNode(root);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::find(const_iterator hint, KeyParam key) -> iterator {
+    AVLNode *last = nullptr;
+    return iterator(findNodeFrom(searchStart(hintNode(hint), key), key, last), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::find(const_iterator hint, KeyParam key) const -> const_iterator {
+    AVLNode *last = nullptr;
+    return const_iterator(findNodeFrom(searchStart(hintNode(hint), key), key, last), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+auto AVLTree<Key, Value, Compare, Allocator>::find(const_iterator hint, const K &key) -> iterator {
+    AVLNode *last = nullptr;
+    return iterator(findNodeFrom(searchStart(hintNode(hint), key), key, last), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+auto AVLTree<Key, Value, Compare, Allocator>::find(const_iterator hint, const K &key) const -> const_iterator {
+    AVLNode *last = nullptr;
+    return const_iterator(findNodeFrom(searchStart(hintNode(hint), key), key, last), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::insert(const_iterator hint, KeyParam key,
+                                                     const Value &value) -> iterator {
+    AVLTREE_TIME(insertLatency);
+    AVLNode *parent = nullptr;
+    bool goRight = false;
+    if (AVLNode *existing = findInsertPositionFrom(searchStart(hintNode(hint), key), key, parent, goRight)) {
+        return iterator(existing, this);
+    }
+    AVLNode *newNode = createNode(key, value);
+    attachNode(newNode, parent, goRight);
+    return iterator(newNode, this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::setFingerSearch(bool enabled) {
+    fingerEnabled = enabled;
+    finger = nullptr;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+bool AVLTree<Key, Value, Compare, Allocator>::fingerSearch() const {
+    return fingerEnabled;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::attachNode(AVLNode *newNode, AVLNode *parent, bool goRight) {
+    if (!parent) {
+        // tree is empty, new node becomes root
+        root = newNode;
+    } else {
+        setChild(parent, goRight, newNode); // insert as left or right child
+    }
+    treeSize++; // increment size of tree upon successful insertion
+    adjustSizesToRoot(parent, 1); // every ancestor gained one node
+    retrace(parent); // walk back up the path we came down
+    moveFinger(newNode);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::retrace(AVLNode *node) {
+    [[maybe_unused]] std::uint64_t depth = 0;
+    while (node) {
+        AVLTREE_COUNT(retraceSteps);
+        AVLTREE_COUNT_MAX(maxRetraceDepth, ++depth);
+        std::uint8_t oldHeight = node->height;
+        AVLNode *subtreeRoot = balanceNode(node);
+        if (subtreeRoot->height == oldHeight) {
+            // this subtree is as tall as before, nothing above it can have changed
+            return;
+        }
+        node = subtreeRoot->parent;
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+bool AVLTree<Key, Value, Compare, Allocator>::remove(KeyParam key) {
+    AVLTREE_TIME(removeLatency);
+    return removeKey(key);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+bool AVLTree<Key, Value, Compare, Allocator>::contains(KeyParam key) const {
+    AVLTREE_TIME(containsLatency);
+    return findNode(key) != nullptr;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+std::optional<Value> AVLTree<Key, Value, Compare, Allocator>::get(KeyParam key) const {
+    AVLTREE_TIME(getLatency);
+    if (AVLNode *node = findNode(key)) {
+        return node->value(); // return value
+    }
+    return std::nullopt; // key not found
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+Value &AVLTree<Key, Value, Compare, Allocator>::operator[](KeyParam key) {
+    // overload operator to access value by key
+    return findOrInsertDefault(key);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+bool AVLTree<Key, Value, Compare, Allocator>::remove(const K &key) {
+    AVLTREE_TIME(removeLatency);
+    return removeKey(key);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+bool AVLTree<Key, Value, Compare, Allocator>::contains(const K &key) const {
+    AVLTREE_TIME(containsLatency);
+    return findNode(key) != nullptr;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+std::optional<Value> AVLTree<Key, Value, Compare, Allocator>::get(const K &key) const {
+    AVLTREE_TIME(getLatency);
+    if (AVLNode *node = findNode(key)) {
+        return node->value();
+    }
+    return std::nullopt;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+Value &AVLTree<Key, Value, Compare, Allocator>::operator[](const K &key) {
+    return findOrInsertDefault(key);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+bool AVLTree<Key, Value, Compare, Allocator>::removeKey(const K &key) {
+    AVLNode *node = findNode(key);
+    if (!node) {
+        return false; // key not found
+    }
+    // the finger moves to a neighbour, so removing keys in order stays cheap;
+    // relinking keeps every other node where it is
+    AVLNode *neighbour = fingerEnabled ? nextNode(node) : nullptr;
+    if (fingerEnabled && !neighbour) {
+        neighbour = prevNode(node);
+    }
+    removeNode(node);
+    moveFinger(neighbour);
+    return true;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+Value &AVLTree<Key, Value, Compare, Allocator>::findOrInsertDefault(const K &key) {
+    AVLNode *parent = nullptr;
+    bool goRight = false;
+    if (AVLNode *existing = findInsertPosition(key, parent, goRight)) {
+        return existing->value();
+    }
+    // only a missing key pays for building a Key
+    AVLNode *newNode = createNode(Key(key));
+    attachNode(newNode, parent, goRight);
+    return newNode->value();
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+auto AVLTree<Key, Value, Compare, Allocator>::lowerBoundNode(const K &key) const -> AVLNode * {
+    // the last node we went left at is the smallest key seen so far that is >= key
+    AVLNode *current = root;
+    AVLNode *bound = nullptr;
+    KeyDescent<Key, Compare, K> order(comp, key);
+    while (current) {
+        AVLTREE_COUNT(comparisons);
+        if (order(current->key()) > 0) {
+            current = current->right;
+        } else {
+            bound = current;
+            current = current->left;
+        }
+    }
+    return bound;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+auto AVLTree<Key, Value, Compare, Allocator>::upperBoundNode(const K &key) const -> AVLNode * {
+    AVLNode *current = root;
+    AVLNode *bound = nullptr;
+    KeyDescent<Key, Compare, K> order(comp, key);
+    while (current) {
+        AVLTREE_COUNT(comparisons);
+        if (order(current->key()) < 0) {
+            bound = current;
+            current = current->left;
+        } else {
+            current = current->right;
+        }
+    }
+    return bound;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::begin() -> iterator {
+    return iterator(minNode(root), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::begin() const -> const_iterator {
+    return const_iterator(minNode(root), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::end() -> iterator {
+    return iterator(nullptr, this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::end() const -> const_iterator {
+    return const_iterator(nullptr, this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::cbegin() const -> const_iterator {
+    return begin();
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::cend() const -> const_iterator {
+    return end();
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::rbegin() -> reverse_iterator {
+    return reverse_iterator(end());
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::rbegin() const -> const_reverse_iterator {
+    return const_reverse_iterator(end());
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::rend() -> reverse_iterator {
+    return reverse_iterator(begin());
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::rend() const -> const_reverse_iterator {
+    return const_reverse_iterator(begin());
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::find(KeyParam key) -> iterator {
+    return iterator(findNode(key), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::find(KeyParam key) const -> const_iterator {
+    return const_iterator(findNode(key), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::lower_bound(KeyParam key) -> iterator {
+    return iterator(lowerBoundNode(key), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::lower_bound(KeyParam key) const -> const_iterator {
+    return const_iterator(lowerBoundNode(key), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::upper_bound(KeyParam key) -> iterator {
+    return iterator(upperBoundNode(key), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::upper_bound(KeyParam key) const -> const_iterator {
+    return const_iterator(upperBoundNode(key), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::equal_range(KeyParam key) -> std::pair<iterator, iterator> {
+    return {lower_bound(key), upper_bound(key)};
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::equal_range(KeyParam key) const
+    -> std::pair<const_iterator, const_iterator> {
+    return {lower_bound(key), upper_bound(key)};
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+auto AVLTree<Key, Value, Compare, Allocator>::find(const K &key) -> iterator {
+    return iterator(findNode(key), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+auto AVLTree<Key, Value, Compare, Allocator>::find(const K &key) const -> const_iterator {
+    return const_iterator(findNode(key), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+auto AVLTree<Key, Value, Compare, Allocator>::lower_bound(const K &key) -> iterator {
+    return iterator(lowerBoundNode(key), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+auto AVLTree<Key, Value, Compare, Allocator>::lower_bound(const K &key) const -> const_iterator {
+    return const_iterator(lowerBoundNode(key), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+auto AVLTree<Key, Value, Compare, Allocator>::upper_bound(const K &key) -> iterator {
+    return iterator(upperBoundNode(key), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+auto AVLTree<Key, Value, Compare, Allocator>::upper_bound(const K &key) const -> const_iterator {
+    return const_iterator(upperBoundNode(key), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+auto AVLTree<Key, Value, Compare, Allocator>::equal_range(const K &key) -> std::pair<iterator, iterator> {
+    return {lower_bound(key), upper_bound(key)};
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+auto AVLTree<Key, Value, Compare, Allocator>::equal_range(const K &key) const
+    -> std::pair<const_iterator, const_iterator> {
+    return {lower_bound(key), upper_bound(key)};
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+size_t AVLTree<Key, Value, Compare, Allocator>::countBelow(const K &key, bool inclusive) const {
+    // every time we go right, the node and its whole left subtree are below key
+    size_t count = 0;
+    AVLNode *current = root;
+    KeyDescent<Key, Compare, K> order(comp, key);
+    while (current) {
+        AVLTREE_COUNT(comparisons);
+        int side = order(current->key());
+        bool goRight = inclusive ? side >= 0 : side > 0;
+        if (goRight) {
+            count += sizeOf(current->left) + 1;
+            current = current->right;
+        } else {
+            current = current->left;
+        }
+    }
+    return count;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::selectNode(size_t k) const -> AVLNode * {
+    AVLNode *current = root;
+    while (current) {
+        size_t leftSize = sizeOf(current->left);
+        if (k < leftSize) {
+            current = current->left;
+        } else if (k == leftSize) {
+            return current;
+        } else {
+            k -= leftSize + 1; // skip the left subtree and this node
+            current = current->right;
+        }
+    }
+    return nullptr; // k is past the last key
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+size_t AVLTree<Key, Value, Compare, Allocator>::rank(KeyParam key) const {
+    return countBelow(key, false);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::select(size_t k) -> iterator {
+    return iterator(selectNode(k), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::select(size_t k) const -> const_iterator {
+    return const_iterator(selectNode(k), this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+size_t AVLTree<Key, Value, Compare, Allocator>::countRange(KeyParam lowKey, KeyParam highKey) const {
+    if (comp(highKey, lowKey)) {
+        return 0;
+    }
+    return countBelow(highKey, true) - countBelow(lowKey, false);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+size_t AVLTree<Key, Value, Compare, Allocator>::rank(const K &key) const {
+    return countBelow(key, false);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+size_t AVLTree<Key, Value, Compare, Allocator>::countRange(const K &lowKey, const K &highKey) const {
+    if (comp(highKey, lowKey)) {
+        return 0;
+    }
+    return countBelow(highKey, true) - countBelow(lowKey, false);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::erase(const_iterator pos) -> iterator {
+    AVLNode *next = nextNode(pos.node); // nodes are relinked, never moved, so next stays valid
+    removeNode(pos.node);
+    return iterator(next, this);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+vector<Key> AVLTree<Key, Value, Compare, Allocator>::findRange(const Key &lowKey, const Key &highKey) const {
+    AVLTREE_TIME(findRangeLatency);
+    vector<Key> keys; // vector to store keys in range
+    forEachInRange(lowKey, highKey, [&keys](const Key &key, const Value &) {
+        keys.push_back(key); // add key to vector
+    });
+    return keys; // return vector of keys
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::range(KeyParam lowKey, KeyParam highKey)
+    -> std::ranges::subrange<iterator> {
+    if (comp(highKey, lowKey)) {
+        return {end(), end()}; // empty range, the bounds would otherwise cross
+    }
+    return {lower_bound(lowKey), upper_bound(highKey)};
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::range(KeyParam lowKey, KeyParam highKey) const
+    -> std::ranges::subrange<const_iterator> {
+    if (comp(highKey, lowKey)) {
+        return {end(), end()};
+    }
+    return {lower_bound(lowKey), upper_bound(highKey)};
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename Visitor>
+size_t AVLTree<Key, Value, Compare, Allocator>::forEachInRange(KeyParam lowKey, KeyParam highKey, Visitor &&visit,
+                                                               size_t limit, bool reverse) const {
+    if (comp(highKey, lowKey)) {
+        return 0;
+    }
+    // start at one end of the range and step through neighbours until past the other end
+    AVLNode *current;
+    if (reverse) {
+        AVLNode *above = upperBoundNode(highKey);
+        current = above ? prevNode(above) : maxNode(root);
+    } else {
+        current = lowerBoundNode(lowKey);
+    }
+    size_t visited = 0;
+    while (current && visited < limit) {
+        if (reverse ? comp(current->key(), lowKey) : comp(highKey, current->key())) {
+            break; // walked out of the range
+        }
+        visited++;
+        if constexpr (std::is_same_v<std::invoke_result_t<Visitor &, const Key &, const Value &>, bool>) {
+            if (!visit(current->key(), current->value())) {
+                break; // visitor asked to stop
+            }
+        } else {
+            visit(current->key(), current->value());
+        }
+        current = reverse ? prevNode(current) : nextNode(current);
+    }
+    return visited;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+std::vector<Key> AVLTree<Key, Value, Compare, Allocator>::keys() const {
+    vector<Key> keys; // vector to store all keys
+    keys.reserve(treeSize);
+    for (const value_type &entry : *this) {
+        keys.push_back(entry.first); // in-order walk, so keys come out sorted
+    }
+    return keys; // return vector of all keys
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+size_t AVLTree<Key, Value, Compare, Allocator>::size() const {
+    // return size of tree
+    return treeSize;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+bool AVLTree<Key, Value, Compare, Allocator>::empty() const {
+    return treeSize == 0;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::clear() {
+    if constexpr (requires { nodeAlloc.soleOwner(); }) {
+        if (nodeAlloc.soleOwner()) {
+            // nobody else allocates from the pool, so drop the slabs wholesale
+            destroyKeys(root);
+            nodeAlloc.getPool().release();
+            root = nullptr;
+            treeSize = 0;
+            finger = nullptr;
+            return;
+        }
+    }
+    deleteTree(root, parallelForkDepth());
+    root = nullptr;
+    treeSize = 0;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+size_t AVLTree<Key, Value, Compare, Allocator>::getHeight() const {
+    // return height of tree, an empty tree reports 0 like a single leaf
+    return root ? root->height : 0;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::verify() const {
+    if (verifyNode(root, nullptr, nullptr, nullptr) != treeSize) {
+        throw std::logic_error("AVLTree::verify: size() does not match the node count");
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+size_t AVLTree<Key, Value, Compare, Allocator>::verifyNode(const AVLNode *node, const AVLNode *parent,
+                                                           const AVLNode *low, const AVLNode *high) const {
+    if (!node) {
+        return 0;
+    }
+    if (node->parent != parent) {
+        throw std::logic_error("AVLTree::verify: broken parent link");
+    }
+    if ((low && !comp(low->key(), node->key())) || (high && !comp(node->key(), high->key()))) {
+        throw std::logic_error("AVLTree::verify: keys out of order");
+    }
+    size_t count = 1 + verifyNode(node->left, node, low, node) + verifyNode(node->right, node, node, high);
+    int leftHeight = heightOf(node->left);
+    int rightHeight = heightOf(node->right);
+    if (node->height != 1 + std::max(leftHeight, rightHeight)) {
+        throw std::logic_error("AVLTree::verify: stale height");
+    }
+    if (std::abs(leftHeight - rightHeight) > 1) {
+        throw std::logic_error("AVLTree::verify: subtree out of balance");
+    }
+    if (node->subtreeSize != count) {
+        throw std::logic_error("AVLTree::verify: stale subtree size");
+    }
+    return count;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::get_allocator() const -> allocator_type {
+    return allocator_type(nodeAlloc);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+class AVLTree<Key, Value, Compare, Allocator>::SavedEntryReader {
+public:
+    // reads the first of count entries right away, buildBalanced reads the
+    // current entry and then advances
+    SavedEntryReader(std::istream &in, const Compare &comp, std::uint64_t count)
+        : in(in), comp(comp), remaining(count) {
+        if (remaining > 0) {
+            readEntry();
+        }
+    }
+
+    std::pair<Key, Value> *operator->() { return &current; }
+
+    SavedEntryReader &operator++() {
+        if (--remaining > 0) {
+            Key previous = std::move(current.first);
+            readEntry();
+            if (!comp(previous, current.first)) {
+                throw std::runtime_error("saved AVLTree keys are not in increasing order");
+            }
+        }
+        return *this;
+    }
+
+private:
+    std::istream &in;
+    const Compare &comp;
+    std::uint64_t remaining;
+    std::pair<Key, Value> current;
+
+    void readEntry() {
+        current.first = BinaryCodec<Key>::read(in);
+        current.second = BinaryCodec<Value>::read(in);
+    }
+};
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::save(std::ostream &out) const
+    requires BinarySerializable<Key> && BinarySerializable<Value> {
+    // magic, byte order mark and entry count, then the entries in order
+    writeBytes(out, savedMagic, sizeof(savedMagic));
+    BinaryCodec<std::uint32_t>::write(out, binaryByteOrderMark);
+    BinaryCodec<std::uint64_t>::write(out, treeSize);
+    for (const auto &[key, value] : *this) {
+        BinaryCodec<Key>::write(out, key);
+        BinaryCodec<Value>::write(out, value);
+    }
+    if (!out) {
+        throw std::runtime_error("writing the AVLTree failed");
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::save(const std::string &path) const
+    requires BinarySerializable<Key> && BinarySerializable<Value> {
+    std::string partial = path + ".tmp";
+    {
+        std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("cannot create " + partial);
+        }
+        save(out);
+        out.close();
+        if (!out) {
+            throw std::runtime_error("writing " + partial + " failed");
+        }
+    }
+    std::filesystem::rename(partial, path);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::load(std::istream &in)
+    requires BinarySerializable<Key> && BinarySerializable<Value> {
+    char magic[sizeof(savedMagic)];
+    readBytes(in, magic, sizeof(magic), "the AVLTree header");
+    if (std::memcmp(magic, savedMagic, sizeof(magic)) != 0) {
+        throw std::runtime_error("not a saved AVLTree");
+    }
+    if (BinaryCodec<std::uint32_t>::read(in) != binaryByteOrderMark) {
+        throw std::runtime_error("saved AVLTree has the wrong byte order");
+    }
+    std::uint64_t count = BinaryCodec<std::uint64_t>::read(in);
+    // build beside the current tree so a bad file leaves it untouched; a
+    // throw part way frees whatever was built
+    SavedEntryReader reader(in, comp, count);
+    AVLNode *newRoot = buildBalanced(reader, size_t(count));
+    AVLNode *oldRoot = root;
+    root = newRoot;
+    treeSize = size_t(count);
+    deleteTree(oldRoot, parallelForkDepth());
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::load(const std::string &path)
+    requires BinarySerializable<Key> && BinarySerializable<Value> {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    load(in);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+AVLTree<Key, Value, Compare, Allocator>::AVLTree(const AVLTree &other)
+    : root(), treeSize(0), comp(other.comp),
+      nodeAlloc(NodeTraits::select_on_container_copy_construction(other.nodeAlloc)) {
+    // copy constructor, a pooled tree gets a pool of its own
+    root = copyTree(other.root, parallelForkDepth()); // copy the tree from other tree and stores return pointer in root
+    treeSize = other.treeSize; // copy size from other tree
+    fingerEnabled = other.fingerEnabled;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+AVLTree<Key, Value, Compare, Allocator>::AVLTree(AVLTree &&other) noexcept
+    : root(), treeSize(0), comp(std::move(other.comp)), nodeAlloc(std::move(other.nodeAlloc)) {
+    fingerEnabled = other.fingerEnabled; // before stealNodes, which keeps the finger only if enabled
+    stealNodes(other);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::operator=(const AVLTree &other) -> AVLTree & {
+    // assignment operator
+    if (this != &other) {
+        // only copy if this and other are different; copy first so a throw leaves
+        // this tree as it was, then free the old nodes one by one (a pool must
+        // not be released wholesale here, the new copy lives in it too)
+        AVLNode *newRoot = copyTree(other.root, parallelForkDepth()); // copy the tree from other tree
+        AVLNode *oldRoot = root;
+        root = newRoot;
+        treeSize = other.treeSize; // copy size from other tree
+        comp = other.comp;
+        fingerEnabled = other.fingerEnabled;
+        finger = nullptr; // it pointed into the old nodes
+        deleteTree(oldRoot, parallelForkDepth()); // delete old tree to avoid memory leaks
+    }
+    return *this;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::operator=(AVLTree &&other)
+    noexcept(NodeTraits::propagate_on_container_move_assignment::value ||
+             NodeTraits::is_always_equal::value) -> AVLTree & {
+    if (this == &other) {
+        return *this;
+    }
+    if constexpr (NodeTraits::propagate_on_container_move_assignment::value) {
+        clear();
+        nodeAlloc = std::move(other.nodeAlloc);
+    } else if (nodeAlloc == other.nodeAlloc) {
+        clear();
+    } else {
+        // our allocator cannot free other's nodes, fall back to copying them
+        *this = other;
+        other.clear();
+        return *this;
+    }
+    comp = std::move(other.comp);
+    fingerEnabled = other.fingerEnabled;
+    stealNodes(other);
+    return *this;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::swap(AVLTree &other) noexcept {
+    using std::swap;
+    swap(root, other.root);
+    swap(treeSize, other.treeSize);
+    swap(comp, other.comp);
+    swap(finger, other.finger);
+    swap(fingerEnabled, other.fingerEnabled);
+    if constexpr (NodeTraits::propagate_on_container_swap::value) {
+        swap(nodeAlloc, other.nodeAlloc);
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::stealNodes(AVLTree &other) noexcept {
+    root = other.root;
+    treeSize = other.treeSize;
+    finger = fingerEnabled ? other.finger : nullptr;
+    other.root = nullptr;
+    other.treeSize = 0;
+    other.finger = nullptr;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+AVLTree<Key, Value, Compare, Allocator>::~AVLTree() {
+    // destructor
+    clear(); // delete the tree to free memory
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+AVLTree<Key, Value, Compare, Allocator>::AVLTree() : root(), treeSize(0), comp(), nodeAlloc() {
+    // constructor initializes root to null and size to 0
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+AVLTree<Key, Value, Compare, Allocator>::AVLTree(const Compare &comp, const Allocator &alloc)
+    : root(), treeSize(0), comp(comp), nodeAlloc(alloc) {
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+AVLTree<Key, Value, Compare, Allocator>::AVLTree(const Allocator &alloc)
+    : root(), treeSize(0), comp(), nodeAlloc(alloc) {
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<std::input_iterator InputIt>
+AVLTree<Key, Value, Compare, Allocator>::AVLTree(InputIt first, InputIt last, const Compare &comp,
+                                                 const Allocator &alloc)
+    : root(), treeSize(0), comp(comp), nodeAlloc(alloc) {
+    try {
+        buildFromSorted(first, last);
+    } catch (...) {
+        clear(); // no destructor runs for a half-built object
+        throw;
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K, typename... Args>
+auto AVLTree<Key, Value, Compare, Allocator>::createNode(K &&key, Args &&... args) -> AVLNode * {
+    AVLNode *node = NodeTraits::allocate(nodeAlloc, 1);
+    try {
+        NodeTraits::construct(nodeAlloc, node, std::forward<K>(key), std::forward<Args>(args)...);
+    } catch (...) {
+        NodeTraits::deallocate(nodeAlloc, node, 1);
+        throw;
+    }
+    AVLTREE_COUNT(allocations);
+    return node;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::destroyNode(AVLNode *node) {
+    AVLTREE_COUNT(deallocations);
+    if (fingerNode() == node) {
+        moveFinger(nullptr);
+    }
+    NodeTraits::destroy(nodeAlloc, node);
+    NodeTraits::deallocate(nodeAlloc, node, 1);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+size_t AVLTree<Key, Value, Compare, Allocator>::AVLNode::numChildren() const {
+    size_t numChildren = 0;
+    if (left) {
+        numChildren++; // increment if left child exists
+    }
+    if (right) {
+        numChildren++; // increment if right child exists
+    }
+    return numChildren; // return total number of children
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+bool AVLTree<Key, Value, Compare, Allocator>::AVLNode::isLeaf() const {
+    return left == nullptr && right == nullptr; // A node is a leaf if left and right children are null
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+size_t AVLTree<Key, Value, Compare, Allocator>::AVLNode::getHeight() const {
+    // return stored height
+    return height;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::nextNode(AVLNode *node) -> AVLNode * {
+    if (node->right) {
+        return minNode(node->right); // smallest key of the right subtree
+    }
+    // otherwise climb until we come up from a left child
+    while (node->parent && node->parent->right == node) {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::prevNode(AVLNode *node) -> AVLNode * {
+    if (node->left) {
+        return maxNode(node->left); // largest key of the left subtree
+    }
+    // otherwise climb until we come up from a right child
+    while (node->parent && node->parent->left == node) {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::minNode(AVLNode *node) -> AVLNode * {
+    while (node && node->left) {
+        node = node->left;
+    }
+    return node;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::maxNode(AVLNode *node) -> AVLNode * {
+    while (node && node->right) {
+        node = node->right;
+    }
+    return node;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::split(KeyParam key) -> AVLTree {
+    return splitAt(key);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+auto AVLTree<Key, Value, Compare, Allocator>::split(const K &key) -> AVLTree {
+    return splitAt(key);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+auto AVLTree<Key, Value, Compare, Allocator>::splitAt(const K &key) -> AVLTree {
+    AVLTree upper(comp, allocator_type(nodeAlloc));
+    AVLNode *all = root;
+    root = nullptr;
+    KeyDescent<Key, Compare, K> order(comp, key);
+    std::pair<AVLNode *, AVLNode *> halves;
+    try {
+        halves = splitNodes(all, order, false);
+    } catch (...) {
+        root = all; // a throwing comparator leaves the tree untouched
+        throw;
+    }
+    auto [below, rest] = halves;
+    size_t restSize = sizeOf(rest);
+    finger = nullptr; // it may have gone to the upper half
+    root = below;
+    treeSize -= restSize;
+    upper.root = rest;
+    upper.treeSize = restSize;
+    upper.fingerEnabled = fingerEnabled; // both halves keep the access pattern they were set up for
+    return upper;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::join(AVLTree &other) {
+    if (this == &other || other.empty()) {
+        return;
+    }
+    if (!empty() && !comp(maxNode(root)->key(), minNode(other.root)->key())) {
+        throw std::invalid_argument("AVLTree::join needs every key of other to order after this tree's keys");
+    }
+    if (!(nodeAlloc == other.nodeAlloc)) {
+        // our allocator cannot free other's nodes, so the entries are moved
+        // into nodes of our own; each lands past the current maximum
+        for (auto &[key, value] : other) {
+            try_emplace(key, std::move(value));
+        }
+        other.clear();
+        return;
+    }
+    AVLNode *left = root;
+    AVLNode *right = other.root;
+    size_t total = treeSize + other.treeSize;
+    other.root = nullptr;
+    other.treeSize = 0;
+    other.finger = nullptr;
+    root = nullptr;
+    root = joinTrees(left, right);
+    treeSize = total;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+size_t AVLTree<Key, Value, Compare, Allocator>::eraseRange(KeyParam lowKey, KeyParam highKey) {
+    return eraseKeyRange(lowKey, highKey);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K> requires TransparentCompare<Compare>
+size_t AVLTree<Key, Value, Compare, Allocator>::eraseRange(const K &lowKey, const K &highKey) {
+    return eraseKeyRange(lowKey, highKey);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+size_t AVLTree<Key, Value, Compare, Allocator>::eraseKeyRange(const K &lowKey, const K &highKey) {
+    if (!root || comp(highKey, lowKey)) {
+        return 0;
+    }
+    // cut out [lowKey, highKey] as one subtree and join what is left around it
+    AVLNode *all = root;
+    root = nullptr;
+    KeyDescent<Key, Compare, K> lowOrder(comp, lowKey);
+    KeyDescent<Key, Compare, K> highOrder(comp, highKey);
+    std::pair<AVLNode *, AVLNode *> lower;
+    std::pair<AVLNode *, AVLNode *> upper;
+    try {
+        lower = splitNodes(all, lowOrder, false);
+    } catch (...) {
+        root = all; // a throwing comparator leaves the tree untouched
+        throw;
+    }
+    try {
+        upper = splitNodes(lower.second, highOrder, true);
+    } catch (...) {
+        root = nullptr;
+        root = joinTrees(lower.first, lower.second); // same entries, maybe another shape
+        throw;
+    }
+    AVLNode *below = lower.first;
+    auto [doomed, above] = upper;
+    root = nullptr;
+    root = joinTrees(below, above);
+    size_t erased = sizeOf(doomed);
+    treeSize -= erased;
+    deleteTree(doomed, parallelForkDepth());
+    return erased;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::unionWith(AVLTree &other) {
+    if (this == &other || other.empty()) {
+        return;
+    }
+    if (!(nodeAlloc == other.nodeAlloc)) {
+        // other's nodes cannot be relinked here, so its entries are moved instead
+        for (auto &[key, value] : other) {
+            try_emplace(key, std::move(value));
+        }
+        other.clear();
+        return;
+    }
+    combineWith(SetOp::unite, other);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::intersect(AVLTree &other) {
+    if (this != &other) {
+        combineWith(SetOp::intersect, other);
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::difference(AVLTree &other) {
+    if (this == &other) {
+        clear();
+        return;
+    }
+    combineWith(SetOp::subtract, other);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::combineWith(SetOp op, AVLTree &other) {
+    AVLNode *mine = root;
+    AVLNode *theirs = other.root;
+    root = nullptr;
+    treeSize = 0;
+    finger = nullptr;
+    other.root = nullptr;
+    other.treeSize = 0;
+    other.finger = nullptr;
+    // forked halves free nodes of both trees, which only an equal allocator may do
+    int forkDepth = nodeAlloc == other.nodeAlloc ? parallelForkDepth() : 0;
+    AVLNode *result;
+    try {
+        result = combineNodes(op, mine, theirs, other, forkDepth);
+    } catch (...) {
+        // every node is freed by now; both roots may still hold scratch from rotations
+        root = nullptr;
+        other.root = nullptr;
+        throw;
+    }
+    root = result;
+    treeSize = sizeOf(result);
+    other.root = nullptr; // it was scratch for other's splits
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::combineNodes(SetOp op, AVLNode *mine, AVLNode *theirs,
+                                                            AVLTree &source, int forkDepth) -> AVLNode * {
+    if (!mine || !theirs) {
+        if (op == SetOp::unite) {
+            return mine ? mine : theirs;
+        }
+        // nothing of theirs survives, and mine only survives a subtraction
+        source.deleteTree(theirs);
+        if (op == SetOp::intersect) {
+            deleteTree(mine);
+            return nullptr;
+        }
+        return mine;
+    }
+    AVLNode *match = nullptr;
+    KeyDescent<Key, Compare, Key> order(comp, mine->key());
+    std::pair<AVLNode *, AVLNode *> theirsSplit;
+    try {
+        theirsSplit = source.splitAround(theirs, order, match);
+    } catch (...) {
+        deleteTree(mine); // theirs came back whole
+        source.deleteTree(theirs);
+        throw;
+    }
+    auto [theirsBelow, theirsAbove] = theirsSplit;
+    auto [mineBelow, mineAbove] = detachChildren(mine);
+
+    // the lower halves go to another thread on a scratch tree of their own,
+    // since rotations at a detached top write the tree's root
+    std::future<AVLNode *> lowerResult;
+    AVLNode *above = nullptr;
+    AVLNode *below = nullptr;
+    try {
+        if (forkDepth > 0 && sizeOf(mineBelow) + sizeOf(theirsBelow) >= parallelCutoff) {
+            try {
+                lowerResult = std::async(std::launch::async, [this, op, mineBelow, theirsBelow, forkDepth] {
+                    AVLTree scratch(comp, allocator_type(nodeAlloc));
+                    AVLNode *lower = nullptr;
+                    try {
+                        lower = scratch.combineNodes(op, mineBelow, theirsBelow, scratch, forkDepth - 1);
+                    } catch (...) {
+                        scratch.root = nullptr; // scratch, the nodes are freed already
+                        throw;
+                    }
+                    scratch.root = nullptr;
+                    return lower;
+                });
+                mineBelow = theirsBelow = nullptr; // the worker owns them now
+            } catch (const std::system_error &) {
+                // no thread to spare, combine the lower halves here below
+            }
+        }
+        // a combineNodes that throws has freed its own inputs, so each pair is
+        // handed over before the call
+        above = combineNodes(op, std::exchange(mineAbove, nullptr), std::exchange(theirsAbove, nullptr), source,
+                             forkDepth - 1);
+        below = lowerResult.valid()
+                    ? lowerResult.get()
+                    : combineNodes(op, std::exchange(mineBelow, nullptr), std::exchange(theirsBelow, nullptr),
+                                   source, forkDepth - 1);
+    } catch (...) {
+        // free whatever this level still holds, so a throwing comparator or
+        // worker leaks nothing
+        if (lowerResult.valid()) {
+            try {
+                deleteTree(lowerResult.get());
+            } catch (...) {
+                // the worker freed its halves before throwing
+            }
+        }
+        deleteTree(above);
+        deleteTree(mineAbove);
+        deleteTree(mineBelow);
+        source.deleteTree(theirsAbove);
+        source.deleteTree(theirsBelow);
+        destroyNode(mine);
+        if (match) {
+            source.destroyNode(match);
+        }
+        throw;
+    }
+
+    if (match) {
+        source.destroyNode(match); // mine holds the key and the value that is kept
+    }
+    bool keep = op == SetOp::intersect ? match != nullptr : op == SetOp::unite || !match;
+    if (keep) {
+        return joinNodes(below, mine, above);
+    }
+    destroyNode(mine);
+    return joinTrees(below, above);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+auto AVLTree<Key, Value, Compare, Allocator>::splitAround(AVLNode *node, KeyDescent<Key, Compare, K> &order,
+                                                          AVLNode *&match) -> std::pair<AVLNode *, AVLNode *> {
+    if (!node) {
+        return {nullptr, nullptr};
+    }
+    AVLTREE_COUNT(comparisons);
+    int side = order(node->key());
+    auto [left, right] = detachChildren(node);
+    if (side == 0) {
+        match = node;
+        return {left, right};
+    }
+    std::pair<AVLNode *, AVLNode *> halves;
+    try {
+        halves = splitAround(side > 0 ? right : left, order, match);
+    } catch (...) {
+        // as in splitNodes: nothing is joined yet, relink node and pass it on
+        setChild(node, false, left);
+        setChild(node, true, right);
+        throw;
+    }
+    auto [below, above] = halves;
+    if (side > 0) {
+        return {joinNodes(left, node, below), above};
+    }
+    return {below, joinNodes(above, node, right)};
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+int AVLTree<Key, Value, Compare, Allocator>::heightOf(const AVLNode *node) {
+    return node ? node->height : -1;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::detachChildren(AVLNode *node) -> std::pair<AVLNode *, AVLNode *> {
+    AVLNode *left = node->left;
+    AVLNode *right = node->right;
+    if (left) {
+        left->parent = nullptr;
+    }
+    if (right) {
+        right->parent = nullptr;
+    }
+    node->left = nullptr;
+    node->right = nullptr;
+    node->parent = nullptr;
+    return {left, right};
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::joinNodes(AVLNode *left, AVLNode *middle,
+                                                         AVLNode *right) -> AVLNode * {
+    int leftHeight = heightOf(left);
+    int rightHeight = heightOf(right);
+    if (std::abs(leftHeight - rightHeight) <= 1) {
+        // already close enough in height for middle to sit on top
+        setChild(middle, false, left);
+        setChild(middle, true, right);
+        middle->parent = nullptr;
+        updateHeight(middle);
+        updateSize(middle);
+        return middle;
+    }
+    // walk down the inner spine of the taller tree to the first subtree no more
+    // than one taller than the shorter tree, hang middle there and rebalance
+    // back up; each level needs at most one single or double rotation
+    bool leftTaller = leftHeight > rightHeight;
+    AVLNode *tall = leftTaller ? left : right;
+    AVLNode *shortTree = leftTaller ? right : left;
+    AVLNode *parent = tall;
+    AVLNode *cut = tall->child(leftTaller);
+    while (heightOf(cut) > heightOf(shortTree) + 1) {
+        parent = cut;
+        cut = cut->child(leftTaller);
+    }
+    setChild(middle, !leftTaller, cut);
+    setChild(middle, leftTaller, shortTree);
+    updateHeight(middle);
+    updateSize(middle);
+    setChild(parent, leftTaller, middle);
+
+    AVLNode *top = parent;
+    for (AVLNode *node = parent; node; node = top->parent) {
+        updateSize(node); // rotations below need the sizes of node's children to be right
+        top = balanceNode(node);
+    }
+    return top;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::joinTrees(AVLNode *left, AVLNode *right) -> AVLNode * {
+    if (!left) {
+        return right;
+    }
+    if (!right) {
+        return left;
+    }
+    // the largest node on the left becomes the middle of a three-way join
+    AVLNode *middle = nullptr;
+    AVLNode *rest = splitLast(left, middle);
+    return joinNodes(rest, middle, right);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::splitLast(AVLNode *node, AVLNode *&last) -> AVLNode * {
+    auto [left, right] = detachChildren(node);
+    if (!right) {
+        last = node;
+        return left;
+    }
+    AVLNode *rest = splitLast(right, last);
+    return joinNodes(left, node, rest);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+auto AVLTree<Key, Value, Compare, Allocator>::splitNodes(AVLNode *node, KeyDescent<Key, Compare, K> &order,
+                                                         bool inclusive) -> std::pair<AVLNode *, AVLNode *> {
+    if (!node) {
+        return {nullptr, nullptr};
+    }
+    // one root-to-leaf walk; on the way back each node rejoins the side it
+    // belongs to with the subtree it came with, and the join heights telescope
+    // to O(log n) in total
+    AVLTREE_COUNT(comparisons);
+    int side = order(node->key());
+    auto [left, right] = detachChildren(node);
+    bool goRight = side > 0 || (side == 0 && inclusive);
+    std::pair<AVLNode *, AVLNode *> halves;
+    try {
+        halves = splitNodes(goRight ? right : left, order, inclusive);
+    } catch (...) {
+        // the comparator threw further down, before anything was joined, so
+        // relinking node hands the caller its subtree back exactly as it was
+        setChild(node, false, left);
+        setChild(node, true, right);
+        throw;
+    }
+    auto [below, above] = halves;
+    if (goRight) {
+        return {joinNodes(left, node, below), above};
+    }
+    return {below, joinNodes(above, node, right)};
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::removeNode(AVLNode *node) {
+    AVLNode *retraceFrom;
+    if (node->left && node->right) {
+        // two children: the in-order successor (leftmost node of the right subtree)
+        // is relinked into node's place, so no key or value is copied
+        AVLNode *successor = minNode(node->right);
+        if (successor->parent == node) {
+            retraceFrom = successor; // successor keeps its own right subtree
+        } else {
+            retraceFrom = successor->parent;
+            setChild(successor->parent, false, successor->right); // splice successor out
+            setChild(successor, true, node->right);
+        }
+        setChild(successor, false, node->left);
+        successor->height = node->height; // retrace fixes this if the subtree shrank
+        successor->subtreeSize = node->subtreeSize; // the walk below takes one off
+        parentLink(node) = successor;
+        successor->parent = node->parent;
+    } else {
+        // zero or one child: the child (possibly null) takes node's place
+        AVLNode *child = node->left ? node->left : node->right;
+        parentLink(node) = child;
+        if (child) {
+            child->parent = node->parent;
+        }
+        retraceFrom = node->parent;
+    }
+    destroyNode(node);
+    treeSize--; // decrement tree size after successful deletion
+    adjustSizesToRoot(retraceFrom, -1); // sizes must be right before rotations recompute them
+    retrace(retraceFrom);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::balanceNode(AVLNode *node) -> AVLNode * {
+    updateHeight(node); // update height of node
+    int balance = getBalance(node);
+    if (balance == -2) {
+        if (getBalance(node->right) == 1) {
+            // double rotation case
+            AVLTREE_COUNT(rotationsRightLeft);
+            rotateRight(node->right);
+        } else {
+            AVLTREE_COUNT(rotationsLeft);
+        }
+        return rotateLeft(node); // single rotation case
+    }
+    if (balance == 2) {
+        if (getBalance(node->left) == -1) {
+            // double rotation case
+            AVLTREE_COUNT(rotationsLeftRight);
+            rotateLeft(node->left);
+        } else {
+            AVLTREE_COUNT(rotationsRight);
+        }
+        return rotateRight(node); // single rotation case
+    }
+    return node; // already balanced, node is still the subtree root
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::deleteTree(AVLNode *current, int forkDepth) {
+    if (!current) {
+        return; // base case: current is null
+    }
+    if (forkDepth > 0 && current->subtreeSize >= parallelCutoff) {
+        // free the left subtree on another thread while this one frees the right;
+        // this runs from destructors, so failing to start a thread must not throw
+        std::future<void> left;
+        try {
+            left = std::async(std::launch::async, [this, current, forkDepth] {
+                deleteTree(current->left, forkDepth - 1);
+            });
+        } catch (const std::system_error &) {
+            // no thread to spare, the left subtree is freed here below
+        }
+        deleteTree(current->right, forkDepth - 1);
+        if (left.valid()) {
+            left.wait();
+        } else {
+            deleteTree(current->left, forkDepth - 1);
+        }
+    } else {
+        deleteTree(current->left); // recursive call to delete left subtree
+        deleteTree(current->right); // recursive call to delete right subtree
+    }
+    destroyNode(current); // delete current node
+}
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::destroyKeys(AVLNode *current) {
+    if constexpr (!std::is_trivially_destructible_v<AVLNode>) {
+        if (!current) {
+            return;
+        }
+        destroyKeys(current->left);
+        destroyKeys(current->right);
+        NodeTraits::destroy(nodeAlloc, current); // memory goes back with the slab
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::copyTree(const AVLNode *current, int forkDepth) -> AVLNode * {
+    if (!current) {
+        return nullptr; // base case: current is null
+    }
+    AVLNode *newNode = createNode(current->key(), current->value()); // create new node with current key and value
+    newNode->height = current->height; // copy height
+    newNode->subtreeSize = current->subtreeSize;
+
+    try {
+        // large subtrees copy their two halves concurrently
+        auto [left, right] = forkJoin(forkDepth > 0 && current->subtreeSize >= parallelCutoff,
+                                      [&] { return copyTree(current->left, forkDepth - 1); },
+                                      [&] { return copyTree(current->right, forkDepth - 1); });
+        setChild(newNode, false, left); // rotations and rebalancing walk parent links
+        setChild(newNode, true, right);
+    } catch (...) {
+        destroyNode(newNode); // the halves already freed themselves
+        throw;
+    }
+
+    return newNode;
+}
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::printTree(AVLNode *current, std::ostream &os, int depth) const {
+    if (!current) {
+        return;
+    }
+    printTree(current->right, os, depth + 1); // print right subtree first
+    for (int i = 0; i < depth; i++) {
+        // depth indicates level in tree and helps with indentation
+        os << "    "; // Indentation to help it look more like a tree
+    }
+    os << "{ " << current->key() << ", " << current->value() << " }" << std::endl;
+    printTree(current->left, os, depth + 1); // print left subtree
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::setChild(AVLNode *parent, bool rightSide, AVLNode *child) {
+    // set child of parent and point the child back at its new parent
+    parent->child(rightSide) = child;
+    if (child != nullptr) {
+        child->parent = parent;
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::parentLink(AVLNode *node) -> AVLNode *& {
+    // the pointer that currently refers to node: root or one of its parent's children
+    if (node->parent == nullptr) {
+        return root;
+    }
+    return node->parent->child(node->parent->right == node);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::updateHeight(AVLNode *current) {
+    // update height of current node
+    if (!current) {
+        return;
+    }
+    int leftHeight = -1; // initialize left height
+    if (current->left != nullptr) {
+        // if left child exists
+        leftHeight = current->left->height; // set left height
+    }
+    int rightHeight = -1; // initialize right height
+    if (current->right != nullptr) {
+        // if right child exists
+        rightHeight = current->right->height; // set right height
+    }
+    current->height = 1 + std::max(leftHeight, rightHeight); // update height of current node
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+size_t AVLTree<Key, Value, Compare, Allocator>::sizeOf(const AVLNode *node) {
+    return node ? node->subtreeSize : 0;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::updateSize(AVLNode *current) {
+    current->subtreeSize = 1 + sizeOf(current->left) + sizeOf(current->right);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void AVLTree<Key, Value, Compare, Allocator>::adjustSizesToRoot(AVLNode *node, std::ptrdiff_t delta) {
+    for (; node != nullptr; node = node->parent) {
+        node->subtreeSize += delta;
+    }
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+int AVLTree<Key, Value, Compare, Allocator>::getBalance(AVLNode *current) {
+    // get balance factor of current node
+    int leftHeight = -1; // initialize left height
+    if (current->left != nullptr) {
+        // if left child exists
+        leftHeight = current->left->height; // set left height
+    }
+    int rightHeight = -1; // initialize right height
+    if (current->right != nullptr) {
+        // if right child exists
+        rightHeight = current->right->height; // set right height
+    }
+    return leftHeight - rightHeight; // return balance factor
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::rotate(AVLNode *current, bool rightChildUp) -> AVLNode * {
+    // the child on the rightChildUp side becomes the subtree root, current
+    // moves down to the opposite side and adopts the child's inner subtree
+    AVLNode *pivot = current->child(rightChildUp);
+    AVLNode *inner = pivot->child(!rightChildUp);
+    parentLink(current) = pivot;
+    pivot->parent = current->parent;
+    setChild(pivot, !rightChildUp, current);
+    setChild(current, rightChildUp, inner);
+
+    updateHeight(current);
+    updateHeight(pivot);
+    updateSize(current); // the pair's total is unchanged, so ancestors need no update
+    updateSize(pivot);
+
+    return pivot; // return new root of rotated subtree
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::rotateRight(AVLNode *current) -> AVLNode * {
+    return rotate(current, false); // left child moves up
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+auto AVLTree<Key, Value, Compare, Allocator>::rotateLeft(AVLNode *current) -> AVLNode * {
+    return rotate(current, true); // right child moves up
+}
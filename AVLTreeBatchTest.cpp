@@ -0,0 +1,110 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for getBatch, containsBatch and insertBatch with unsorted batches
+holding duplicates and missing keys, checked against std::map.
+ */
+#include "AVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+using namespace std;
+
+using Tree = AVLTree<int, int>;
+using Map = map<int, int>;
+
+static void checkLookups(const Tree &tree, const Map &reference, const vector<int> &keys, const string &what) {
+    vector<optional<int> > values = tree.getBatch(keys);
+    vector<bool> present = tree.containsBatch(keys);
+    check(values.size() == keys.size() && present.size() == keys.size(), what + ": result sizes");
+    for (size_t i = 0; i < keys.size(); i++) {
+        auto expected = reference.find(keys[i]);
+        bool found = expected != reference.end();
+        check(present[i] == found, what + ": containsBatch in the caller's order");
+        check(values[i].has_value() == found && (!found || *values[i] == expected->second),
+              what + ": getBatch in the caller's order");
+    }
+}
+
+static void randomBatches() {
+    mt19937 random(11);
+    Tree tree;
+    Map reference;
+    for (int round = 0; round < 200; round++) {
+        // unsorted, with repeats both inside the batch and against the tree
+        vector<pair<int, int> > entries;
+        size_t batchSize = random() % 300;
+        for (size_t i = 0; i < batchSize; i++) {
+            entries.emplace_back(int(random() % 20000), round * 1000 + int(i));
+        }
+        size_t expectedInserted = 0;
+        for (const auto &[key, value] : entries) {
+            expectedInserted += reference.emplace(key, value).second; // earliest in the batch wins
+        }
+        check(tree.insertBatch(entries) == expectedInserted, "insertBatch count");
+
+        vector<int> keys;
+        for (size_t i = 0; i < 400; i++) {
+            keys.push_back(int(random() % 20400) - 200);
+        }
+        checkLookups(tree, reference, keys, "round " + to_string(round));
+        if (round % 20 == 0) {
+            checkTree(tree, reference, "after insertBatch");
+        }
+    }
+    checkTree(tree, reference, "after insertBatch");
+}
+
+static void edgeCases() {
+    Tree tree;
+    Map reference;
+    checkLookups(tree, reference, {1, 2, 3}, "empty tree");
+    checkLookups(tree, reference, {}, "empty batch");
+    check(tree.insertBatch(vector<pair<int, int> >{}) == 0, "empty insertBatch");
+
+    // ascending, descending and all-equal batches
+    vector<pair<int, int> > ascending, descending, same;
+    for (int i = 0; i < 1000; i++) {
+        ascending.emplace_back(i * 2, i);
+        descending.emplace_back(5000 - i * 2, i);
+        same.emplace_back(777, i);
+    }
+    for (auto *batch : {&ascending, &descending, &same}) {
+        size_t expected = 0;
+        for (const auto &[key, value] : *batch) {
+            expected += reference.emplace(key, value).second;
+        }
+        check(tree.insertBatch(*batch) == expected, "sorted batch count");
+        checkTree(tree, reference, "sorted batch");
+    }
+    checkLookups(tree, reference, {777, 777, 0, 5000, -1, 1999}, "repeated keys in a lookup batch");
+}
+
+static void stringKeys() {
+    AVLTree<string, size_t> tree;
+    vector<pair<string, size_t> > entries = {{"kiwi", 4}, {"fig", 3}, {"apple", 5}, {"fig", 30}};
+    check(tree.insertBatch(entries) == 3, "string insertBatch");
+    // transparent comparator: string_view keys look up without building strings
+    vector<string_view> keys = {"fig", "plum", "apple"};
+    vector<optional<size_t> > values = tree.getBatch(keys);
+    check(values[0] == 3 && !values[1] && values[2] == 5, "string_view getBatch");
+    vector<bool> present = tree.containsBatch(keys);
+    check(present[0] && !present[1] && present[2], "string_view containsBatch");
+}
+
+int main() {
+    randomBatches();
+    edgeCases();
+    stringKeys();
+    cout << "batches: ok" << endl;
+    return 0;
+}
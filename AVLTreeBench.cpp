@@ -0,0 +1,401 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * AVLTreeBench.cpp
+ * Throughput benchmarks for AVLTree and CompactAVLTree against std::map and
+ * std::unordered_map. Run the avltree_bench_json target (or pass
+ * --benchmark_out=file.json --benchmark_out_format=json) to record results.
+ */
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AVLTree.h"
+#include "CompactAVLTree.h"
+
+// largest tree size registered; sizes go 1K, 10K, ... up to 100M, and the
+// big ones need tens of GB, so the default stops at 1M (see CMakeLists.txt)
+#ifndef AVLTREE_BENCH_MAX_SIZE
+#define AVLTREE_BENCH_MAX_SIZE 1000000
+#endif
+
+namespace {
+    enum class Distribution { Sequential, Random, Zipfian };
+
+    const char *distributionName(Distribution distribution) {
+        switch (distribution) {
+            case Distribution::Sequential: return "seq";
+            case Distribution::Random: return "random";
+            case Distribution::Zipfian: return "zipf";
+        }
+        return "";
+    }
+
+    // Zipf(theta) over [0, n) as in YCSB (Gray et al., "Quickly generating
+    // billion-record synthetic databases"): rank 0 is the hottest item
+    class ZipfianGenerator {
+    public:
+        explicit ZipfianGenerator(uint64_t n, double theta = 0.99) : n(n), theta(theta) {
+            zetaN = zeta(n);
+            alpha = 1.0 / (1.0 - theta);
+            eta = (1.0 - std::pow(2.0 / double(n), 1.0 - theta)) / (1.0 - zeta(2) / zetaN);
+        }
+
+        template<typename Rng>
+        uint64_t operator()(Rng &rng) {
+            double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+            double uz = u * zetaN;
+            if (uz < 1.0) {
+                return 0;
+            }
+            if (uz < 1.0 + std::pow(0.5, theta)) {
+                return 1;
+            }
+            return std::min<uint64_t>(n - 1, uint64_t(double(n) * std::pow(eta * u - eta + 1.0, alpha)));
+        }
+
+    private:
+        uint64_t n;
+        double theta;
+        double zetaN;
+        double alpha;
+        double eta;
+
+        double zeta(uint64_t count) const {
+            double sum = 0;
+            for (uint64_t i = 1; i <= count; i++) {
+                sum += 1.0 / std::pow(double(i), theta);
+            }
+            return sum;
+        }
+    };
+
+    // key number i; strings share a long URL-like prefix and end in the
+    // zero-padded number, so they sort like the numbers
+    template<typename Key>
+    Key makeKey(uint64_t i, size_t length) {
+        if constexpr (std::is_integral_v<Key>) {
+            return Key(i);
+        } else {
+            std::string digits = std::to_string(i);
+            digits.insert(0, 20 - digits.size(), '0');
+            if (length <= digits.size()) {
+                return digits.substr(digits.size() - length);
+            }
+            static const std::string stem = "https://www.example.com/catalog/items/by-id/";
+            std::string key;
+            key.reserve(length);
+            while (key.size() < length - digits.size()) {
+                key += stem;
+            }
+            key.resize(length - digits.size());
+            return key + digits;
+        }
+    }
+
+    // key numbers 0..n-1 in the order the distribution visits them; Zipfian
+    // draws scatter the hot ranks over the key space
+    std::vector<uint64_t> keyOrder(uint64_t n, size_t count, Distribution distribution, uint32_t seed) {
+        std::mt19937_64 rng(seed);
+        std::vector<uint64_t> order(count);
+        switch (distribution) {
+            case Distribution::Sequential:
+                for (size_t i = 0; i < count; i++) {
+                    order[i] = i % n;
+                }
+                break;
+            case Distribution::Random: {
+                std::uniform_int_distribution<uint64_t> pick(0, n - 1);
+                if (count == n) {
+                    for (size_t i = 0; i < count; i++) {
+                        order[i] = i;
+                    }
+                    std::shuffle(order.begin(), order.end(), rng);
+                } else {
+                    for (uint64_t &key : order) {
+                        key = pick(rng);
+                    }
+                }
+                break;
+            }
+            case Distribution::Zipfian: {
+                ZipfianGenerator zipf(n);
+                for (uint64_t &key : order) {
+                    key = (zipf(rng) * 0x9E3779B97F4A7C15ull) % n;
+                }
+                break;
+            }
+        }
+        return order;
+    }
+
+    template<typename Key>
+    std::vector<Key> makeKeys(const std::vector<uint64_t> &order, size_t length) {
+        std::vector<Key> keys;
+        keys.reserve(order.size());
+        for (uint64_t i : order) {
+            keys.push_back(makeKey<Key>(i, length));
+        }
+        return keys;
+    }
+
+    // the few operations every container is measured on
+    template<typename Container, typename Key>
+    void put(Container &container, const Key &key, size_t value) {
+        if constexpr (requires { container.remove(key); }) {
+            container.insert(key, value);
+        } else {
+            container.emplace(key, value);
+        }
+    }
+
+    template<typename Container, typename Key>
+    bool lookup(const Container &container, const Key &key) {
+        if constexpr (requires { container.get(key); }) {
+            return container.get(key).has_value();
+        } else {
+            return container.find(key) != container.end();
+        }
+    }
+
+    template<typename Container, typename Key>
+    void erase(Container &container, const Key &key) {
+        if constexpr (requires { container.remove(key); }) {
+            container.remove(key);
+        } else {
+            container.erase(key);
+        }
+    }
+
+    // sums up to count values starting at the first key >= low
+    template<typename Container, typename Key>
+    size_t scan(const Container &container, const Key &low, const Key &high, size_t count) {
+        size_t sum = 0;
+        if constexpr (requires { container.lower_bound(low); }) {
+            auto it = container.lower_bound(low);
+            for (size_t i = 0; i < count && it != container.end(); ++i, ++it) {
+                sum += it->second;
+            }
+        } else {
+            container.forEachInRange(low, high, [&sum](const Key &, size_t value) {
+                sum += value;
+            }, count);
+        }
+        return sum;
+    }
+
+    template<typename Container, typename Key>
+    std::unique_ptr<Container> buildContainer(uint64_t n, size_t length) {
+        auto container = std::make_unique<Container>();
+        for (uint64_t i : keyOrder(n, n, Distribution::Random, 1)) {
+            put(*container, makeKey<Key>(i, length), size_t(i));
+        }
+        return container;
+    }
+
+    // the tree of the last lookup or scan benchmark, reused while the next one
+    // asks for the same shape
+    template<typename Container, typename Key>
+    const Container &sharedContainer(uint64_t n, size_t length) {
+        static std::unique_ptr<Container> cached;
+        static uint64_t cachedSize = 0;
+        static size_t cachedLength = 0;
+        if (!cached || cachedSize != n || cachedLength != length) {
+            cached.reset();
+            cached = buildContainer<Container, Key>(n, length);
+            cachedSize = n;
+            cachedLength = length;
+        }
+        return *cached;
+    }
+
+    // keys are inserted in the distribution's order into an empty container
+    template<typename Container, typename Key>
+    void benchInsert(benchmark::State &state, Distribution distribution, size_t length) {
+        uint64_t n = uint64_t(state.range(0));
+        std::vector<Key> keys = makeKeys<Key>(keyOrder(n, n, distribution, 2), length);
+        for (auto _ : state) {
+            Container container;
+            for (size_t i = 0; i < keys.size(); i++) {
+                put(container, keys[i], i);
+            }
+            benchmark::DoNotOptimize(container);
+            state.PauseTiming();
+            { Container discard(std::move(container)); } // teardown is not part of insert
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(int64_t(state.iterations() * n));
+    }
+
+    template<typename Container, typename Key>
+    void benchGet(benchmark::State &state, Distribution distribution, size_t length) {
+        uint64_t n = uint64_t(state.range(0));
+        const Container &container = sharedContainer<Container, Key>(n, length);
+        std::vector<Key> probes = makeKeys<Key>(keyOrder(n, std::min<size_t>(n, 1 << 20), distribution, 3), length);
+        size_t next = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(lookup(container, probes[next]));
+            if (++next == probes.size()) {
+                next = 0;
+            }
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()));
+    }
+
+    template<typename Container, typename Key>
+    void benchRemove(benchmark::State &state, Distribution distribution, size_t length) {
+        uint64_t n = uint64_t(state.range(0));
+        std::vector<Key> keys = makeKeys<Key>(keyOrder(n, n, distribution, 4), length);
+        for (auto _ : state) {
+            state.PauseTiming();
+            std::unique_ptr<Container> container = buildContainer<Container, Key>(n, length);
+            state.ResumeTiming();
+            for (const Key &key : keys) {
+                erase(*container, key);
+            }
+            benchmark::DoNotOptimize(container);
+        }
+        state.SetItemsProcessed(int64_t(state.iterations() * n));
+    }
+
+    // readPercent of the operations are lookups; the rest alternate between
+    // inserting a key outside the initial set and removing one, so the size holds
+    template<typename Container, typename Key>
+    void benchMixed(benchmark::State &state, Distribution distribution, size_t length, int readPercent) {
+        uint64_t n = uint64_t(state.range(0));
+        std::unique_ptr<Container> container = buildContainer<Container, Key>(n, length);
+        size_t count = std::min<size_t>(n, 1 << 20);
+        std::vector<Key> probes = makeKeys<Key>(keyOrder(n, count, distribution, 5), length);
+        // numbers from n up are never in the initial set
+        std::vector<Key> extra;
+        extra.reserve(count);
+        for (uint64_t i : keyOrder(n, count, Distribution::Random, 6)) {
+            extra.push_back(makeKey<Key>(n + i, length));
+        }
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> percent(0, 99);
+        size_t next = 0, nextWrite = 0;
+        bool inserting = true;
+        for (auto _ : state) {
+            if (percent(rng) < readPercent) {
+                benchmark::DoNotOptimize(lookup(*container, probes[next]));
+                next = next + 1 == probes.size() ? 0 : next + 1;
+            } else {
+                if (inserting) {
+                    put(*container, extra[nextWrite], nextWrite);
+                } else {
+                    erase(*container, extra[nextWrite]);
+                    nextWrite = nextWrite + 1 == extra.size() ? 0 : nextWrite + 1;
+                }
+                inserting = !inserting;
+            }
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()));
+    }
+
+    template<typename Container, typename Key>
+    void benchRangeScan(benchmark::State &state, size_t length, size_t scanLength) {
+        uint64_t n = uint64_t(state.range(0));
+        const Container &container = sharedContainer<Container, Key>(n, length);
+        std::vector<Key> starts = makeKeys<Key>(keyOrder(n, std::min<size_t>(n, 1 << 16), Distribution::Random, 8),
+                                                length);
+        Key high = makeKey<Key>(n, length);
+        size_t next = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(scan(container, starts[next], high, scanLength));
+            next = next + 1 == starts.size() ? 0 : next + 1;
+        }
+        state.SetItemsProcessed(int64_t(state.iterations() * scanLength));
+    }
+
+    template<typename Key>
+    using TreeOf = AVLTree<Key, size_t>;
+
+    template<typename Key>
+    using CompactOf = CompactAVLTree<Key, size_t>;
+
+    template<typename Key>
+    using MapOf = std::map<Key, size_t, std::less<> >;
+
+    template<typename Key>
+    using HashOf = std::unordered_map<Key, size_t>;
+
+    template<typename Fn>
+    void registerSizes(const std::string &name, Fn fn, int64_t maxSize = AVLTREE_BENCH_MAX_SIZE) {
+        benchmark::internal::Benchmark *bench = benchmark::RegisterBenchmark(name.c_str(), fn);
+        for (int64_t size = 1000; size <= std::min<int64_t>(maxSize, 100000000); size *= 10) {
+            bench->Arg(size);
+        }
+        bench->Unit(benchmark::kNanosecond);
+    }
+
+    // every benchmark for one key type and container, named like
+    // "get/random/str64/AVLTree/100000"
+    template<template<typename> typename Container, typename Key>
+    void registerContainer(const std::string &containerName, size_t length) {
+        std::string keyName = std::is_integral_v<Key> ? "u64" : "str" + std::to_string(length);
+        for (Distribution distribution : {Distribution::Sequential, Distribution::Random, Distribution::Zipfian}) {
+            std::string suffix = std::string(distributionName(distribution)) + "/" + keyName + "/" + containerName;
+            registerSizes("get/" + suffix, [=](benchmark::State &state) {
+                benchGet<Container<Key>, Key>(state, distribution, length);
+            });
+            if (distribution == Distribution::Zipfian) {
+                continue; // inserting and removing every key once has no skew to draw
+            }
+            registerSizes("insert/" + suffix, [=](benchmark::State &state) {
+                benchInsert<Container<Key>, Key>(state, distribution, length);
+            });
+            registerSizes("remove/" + suffix, [=](benchmark::State &state) {
+                benchRemove<Container<Key>, Key>(state, distribution, length);
+            });
+        }
+        for (int readPercent : {50, 90, 99}) {
+            registerSizes("mixed" + std::to_string(readPercent) + "/zipf/" + keyName + "/" + containerName,
+                          [=](benchmark::State &state) {
+                              benchMixed<Container<Key>, Key>(state, Distribution::Zipfian, length, readPercent);
+                          });
+        }
+        if constexpr (!requires { typename Container<Key>::hasher; }) { // range scans need order
+            for (size_t scanLength : {size_t(10), size_t(1000)}) {
+                registerSizes("scan" + std::to_string(scanLength) + "/" + keyName + "/" + containerName,
+                              [=](benchmark::State &state) {
+                                  benchRangeScan<Container<Key>, Key>(state, length, scanLength);
+                              });
+            }
+        }
+    }
+
+    template<typename Key>
+    void registerKeyType(size_t length) {
+        registerContainer<TreeOf, Key>("AVLTree", length);
+        registerContainer<CompactOf, Key>("CompactAVLTree", length);
+        registerContainer<MapOf, Key>("std::map", length);
+        registerContainer<HashOf, Key>("std::unordered_map", length);
+    }
+}
+
+int main(int argc, char **argv) {
+    registerKeyType<uint64_t>(8);
+    for (size_t length : {16, 64, 256}) {
+        registerKeyType<std::string>(length);
+    }
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::AddCustomContext("key_compare_kernel", KeyCompare::kernelName());
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
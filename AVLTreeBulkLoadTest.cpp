@@ -0,0 +1,131 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for buildFromSorted and the iterator-pair constructor over random
+access, forward and single pass input, including the fallback for unsorted
+input and duplicates, checked against std::map.
+ */
+#include "AVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <bit>
+#include <forward_list>
+#include <iterator>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+using namespace std;
+
+using Tree = AVLTree<int, int>;
+using Map = map<int, int>;
+using Entries = vector<pair<int, int> >;
+
+// input iterator over a vector that can only be walked once, so the tree has
+// to buffer it
+struct SinglePass {
+    using iterator_category = input_iterator_tag;
+    using value_type = pair<int, int>;
+    using difference_type = ptrdiff_t;
+    using pointer = const pair<int, int> *;
+    using reference = const pair<int, int> &;
+
+    const Entries *source = nullptr;
+    size_t index = 0;
+
+    reference operator*() const { return (*source)[index]; }
+    pointer operator->() const { return &(*source)[index]; }
+
+    SinglePass &operator++() {
+        ++index;
+        return *this;
+    }
+
+    SinglePass operator++(int) {
+        SinglePass before = *this;
+        ++index;
+        return before;
+    }
+
+    bool operator==(const SinglePass &other) const { return index == other.index; }
+};
+
+static Entries sortedEntries(size_t count) {
+    Entries entries;
+    for (size_t i = 0; i < count; i++) {
+        entries.emplace_back(int(i * 3), int(i));
+    }
+    return entries;
+}
+
+// sorted input is linked into a perfectly balanced tree: height is the
+// minimum possible for its size, counting a single leaf as 0
+static void checkBalanced(const Tree &tree, const Map &reference, const string &what) {
+    checkTree(tree, reference, what);
+    size_t minimal = reference.empty() ? 0 : size_t(bit_width(reference.size())) - 1;
+    check(tree.getHeight() == minimal, what + ": minimal height");
+}
+
+static void sortedInput() {
+    for (size_t count : {size_t(0), size_t(1), size_t(2), size_t(3), size_t(7), size_t(8), size_t(1000),
+                         Tree::parallelCutoff + 1000}) {
+        Entries entries = sortedEntries(count);
+        Map reference(entries.begin(), entries.end());
+        string what = to_string(count) + " entries";
+
+        Tree tree;
+        tree.insert(-1, -1); // replaced, not kept
+        tree.buildFromSorted(entries.begin(), entries.end());
+        checkBalanced(tree, reference, what + " from a vector");
+
+        forward_list<pair<int, int> > list(entries.begin(), entries.end());
+        tree.buildFromSorted(list.begin(), list.end());
+        checkBalanced(tree, reference, what + " from a forward_list");
+
+        tree.buildFromSorted(SinglePass{&entries, 0}, SinglePass{&entries, entries.size()});
+        checkBalanced(tree, reference, what + " from single pass input");
+
+        Tree constructed(entries.begin(), entries.end());
+        checkBalanced(constructed, reference, what + " from the constructor");
+
+        // still an ordinary tree afterwards
+        constructed.insert(1, 1);
+        constructed.remove(0);
+        reference.emplace(1, 1);
+        reference.erase(0);
+        checkTree(constructed, reference, what + " written after building");
+    }
+}
+
+// anything out of order or repeated is inserted one by one, first duplicate wins
+static void unsortedInput() {
+    mt19937 random(10);
+    Entries entries;
+    Map reference;
+    for (int i = 0; i < 5000; i++) {
+        int key = int(random() % 2000);
+        entries.emplace_back(key, i);
+        reference.emplace(key, i);
+    }
+    Tree tree;
+    tree.buildFromSorted(entries.begin(), entries.end());
+    checkTree(tree, reference, "unsorted input");
+
+    Entries duplicates = {{1, 1}, {2, 2}, {2, 3}, {4, 4}};
+    tree.buildFromSorted(duplicates.begin(), duplicates.end());
+    checkTree(tree, Map{{1, 1}, {2, 2}, {4, 4}}, "sorted input with a duplicate");
+
+    Tree constructed(duplicates.rbegin(), duplicates.rend());
+    checkTree(constructed, Map{{1, 1}, {2, 3}, {4, 4}}, "descending input");
+}
+
+int main() {
+    sortedInput();
+    unsortedInput();
+    cout << "bulk load: ok" << endl;
+    return 0;
+}
@@ -0,0 +1,228 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for finger search and hinted find/insert, checked against std::map.
+The finger must never outlive the node it points at, so every operation that
+frees or moves nodes runs with it on; a counting comparator checks that
+sorted access with a finger or a good hint costs far fewer comparisons.
+ */
+#include "AVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+using namespace std;
+
+// std::less that counts its calls
+struct CountingLess {
+    static inline size_t calls = 0;
+
+    bool operator()(int a, int b) const {
+        calls++;
+        return a < b;
+    }
+};
+
+using Tree = AVLTree<int, int>;
+using CountingTree = AVLTree<int, int, CountingLess>;
+using Map = map<int, int>;
+
+// random writes and lookups, with the finger's node often erased under it
+static void randomOperations() {
+    mt19937 random(24);
+    Tree tree;
+    tree.setFingerSearch(true);
+    check(tree.fingerSearch(), "finger search on");
+    Map reference;
+    int cursor = 0;
+    for (int i = 0; i < 30000; i++) {
+        // mostly walk near the last key, sometimes jump
+        cursor = random() % 8 == 0 ? int(random() % 5000) : cursor + int(random() % 7) - 3;
+        int key = cursor;
+        switch (random() % 5) {
+            case 0:
+                check(tree.remove(key) == (reference.erase(key) == 1), "remove");
+                break;
+            case 1: {
+                auto it = tree.find(key);
+                check((it != tree.end()) == reference.contains(key), "find before erase");
+                if (it != tree.end()) {
+                    tree.erase(it);
+                    reference.erase(key);
+                }
+                break;
+            }
+            case 2:
+                check(tree.get(key) == (reference.contains(key) ? optional(reference[key]) : nullopt), "get");
+                break;
+            default:
+                check(tree.insert(key, i) == reference.emplace(key, i).second, "insert");
+                break;
+        }
+        if (i % 3000 == 0) {
+            checkTree(tree, reference, "finger random operations");
+        }
+    }
+    checkTree(tree, reference, "finger random operations");
+}
+
+// operations that free or hand over nodes wholesale drop or carry the finger
+static void bulkOperations() {
+    Tree tree;
+    Map reference;
+    tree.setFingerSearch(true);
+    for (int key = 0; key < 2000; key++) {
+        tree.insert(key, key);
+        reference.emplace(key, key);
+    }
+    auto lookupsAgree = [&](Tree &t, const Map &expected, const string &what) {
+        for (int key = -1; key <= 2001; key += 37) {
+            auto found = expected.find(key);
+            check(t.get(key) == (found == expected.end() ? nullopt : optional(found->second)), what);
+        }
+        checkTree(t, expected, what);
+    };
+
+    tree.get(1990); // finger near the top, then cut it off
+    Tree upper = tree.split(1000);
+    Map upperReference(reference.lower_bound(1000), reference.end());
+    reference.erase(reference.lower_bound(1000), reference.end());
+    check(upper.fingerSearch() == tree.fingerSearch(), "split half keeps the setting");
+    lookupsAgree(tree, reference, "after split");
+    lookupsAgree(upper, upperReference, "upper half after split");
+
+    upper.get(1500);
+    tree.join(upper);
+    reference.insert(upperReference.begin(), upperReference.end());
+    lookupsAgree(tree, reference, "after join");
+
+    tree.get(500);
+    tree.eraseRange(400, 600);
+    reference.erase(reference.lower_bound(400), reference.upper_bound(600));
+    lookupsAgree(tree, reference, "after eraseRange");
+
+    Tree copy(tree);
+    check(copy.fingerSearch(), "copy keeps finger search");
+    lookupsAgree(copy, reference, "copy");
+
+    Tree assigned;
+    assigned.get(3);
+    assigned = copy;
+    check(assigned.fingerSearch(), "copy assignment takes the setting");
+    lookupsAgree(assigned, reference, "copy assigned");
+
+    Tree moved(std::move(copy));
+    check(moved.fingerSearch(), "move keeps finger search");
+    lookupsAgree(moved, reference, "moved");
+    Tree moveAssigned;
+    moveAssigned = std::move(moved);
+    check(moveAssigned.fingerSearch(), "move assignment takes the setting");
+    lookupsAgree(moveAssigned, reference, "move assigned");
+
+    Tree plain;
+    plain.insert(-5, -5);
+    plain.get(-5);
+    swap(plain, moveAssigned);
+    check(plain.fingerSearch() && !moveAssigned.fingerSearch(), "swap exchanges the setting");
+    lookupsAgree(plain, reference, "swapped");
+    lookupsAgree(moveAssigned, Map{{-5, -5}}, "swapped back");
+
+    Tree other;
+    for (int key = 0; key < 3000; key += 3) {
+        other.insert(key, -key);
+    }
+    plain.get(999);
+    Map united = reference;
+    for (int key = 0; key < 3000; key += 3) {
+        united.emplace(key, -key);
+    }
+    plain.unionWith(other);
+    lookupsAgree(plain, united, "after unionWith");
+
+    plain.get(10);
+    plain.clear();
+    lookupsAgree(plain, Map(), "after clear");
+    plain.insert(7, 7);
+    lookupsAgree(plain, Map{{7, 7}}, "reused after clear");
+}
+
+// hints right next to, far from and at the end of the key all give the same answers
+static void hints() {
+    mt19937 random(25);
+    Tree tree;
+    Map reference;
+    for (int key = 0; key < 10000; key += 2) {
+        tree.insert(key, key);
+        reference.emplace(key, key);
+    }
+    for (int i = 0; i < 20000; i++) {
+        int key = int(random() % 10400) - 200;
+        int near = int(random() % 10000);
+        Tree::const_iterator hint = random() % 10 == 0 ? tree.cend() : Tree::const_iterator(tree.lower_bound(near));
+        auto found = tree.find(hint, key);
+        auto expected = reference.find(key);
+        check(expected == reference.end() ? found == tree.end() : found != tree.end() && found->first == key,
+              "hinted find");
+        if (random() % 4 == 0) {
+            auto inserted = tree.insert(hint, key, i);
+            reference.emplace(key, i);
+            check(inserted->first == key && inserted->second == reference[key], "hinted insert");
+        }
+    }
+    checkTree(tree, reference, "after hinted inserts");
+    check(as_const(tree).find(tree.cbegin(), 9998) != tree.cend(), "const hinted find from the far end");
+}
+
+// sorted access costs a few comparisons per key with a finger or the previous
+// position as hint, against a full descent without
+static void comparisonCounts() {
+    constexpr int count = 1 << 16;
+    auto perKey = [](auto &&work) {
+        CountingLess::calls = 0;
+        work();
+        return double(CountingLess::calls) / count;
+    };
+    CountingTree tree;
+    double descent = perKey([&] {
+        for (int key = 0; key < count; key++) {
+            tree.insert(key, key);
+        }
+    });
+    CountingTree hinted;
+    double withHint = perKey([&] {
+        auto hint = hinted.cend();
+        for (int key = 0; key < count; key++) {
+            hint = hinted.insert(hint, key, key);
+        }
+    });
+    check(withHint * 3 < descent, "appending with a hint skips the descent");
+    checkTree(hinted, Map(tree.begin(), tree.end()), "hinted appends");
+
+    double lookups = perKey([&] {
+        for (int key = 0; key < count; key++) {
+            tree.contains(key);
+        }
+    });
+    tree.setFingerSearch(true);
+    double fingerLookups = perKey([&] {
+        for (int key = 0; key < count; key++) {
+            tree.contains(key);
+        }
+    });
+    check(fingerLookups * 3 < lookups, "sorted lookups with a finger skip the descent");
+}
+
+int main() {
+    randomOperations();
+    bulkOperations();
+    hints();
+    comparisonCounts();
+    cout << "finger search: ok" << endl;
+    return 0;
+}
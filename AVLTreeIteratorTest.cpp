@@ -0,0 +1,135 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for AVLTree iterators, find and the bound queries, checked
+against std::map after random inserts and erases.
+ */
+#include "AVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <climits>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+using namespace std;
+
+using Tree = AVLTree<int, int>;
+using Map = map<int, int>;
+
+// position of it in the tree as a key, or INT_MIN for end()
+static int keyAt(const Tree &tree, Tree::const_iterator it) {
+    return it == tree.end() ? INT_MIN : it->first;
+}
+
+static int keyAt(const Map &reference, Map::const_iterator it) {
+    return it == reference.end() ? INT_MIN : it->first;
+}
+
+static void checkQueries(const Tree &tree, const Map &reference, int key) {
+    string what = "key " + to_string(key);
+    check(keyAt(tree, tree.find(key)) == keyAt(reference, reference.find(key)), what + ": find");
+    check(keyAt(tree, tree.lower_bound(key)) == keyAt(reference, reference.lower_bound(key)), what + ": lower_bound");
+    check(keyAt(tree, tree.upper_bound(key)) == keyAt(reference, reference.upper_bound(key)), what + ": upper_bound");
+    auto [first, last] = tree.equal_range(key);
+    auto [expectedFirst, expectedLast] = reference.equal_range(key);
+    check(keyAt(tree, first) == keyAt(reference, expectedFirst) && keyAt(tree, last) == keyAt(reference, expectedLast),
+          what + ": equal_range");
+}
+
+static void checkTraversals(const Tree &tree, const Map &reference) {
+    checkTree(tree, reference, "forward");
+    auto expected = reference.rbegin();
+    for (auto it = tree.rbegin(); it != tree.rend(); ++it, ++expected) {
+        check(expected != reference.rend() && it->first == expected->first, "reverse iteration");
+    }
+    check(expected == reference.rend(), "reverse iteration length");
+    // walking back from end() with -- visits the same entries
+    size_t steps = 0;
+    for (auto it = tree.end(); it != tree.begin(); steps++) {
+        --it;
+    }
+    check(steps == reference.size(), "decrement from end");
+    check(static_cast<size_t>(distance(tree.cbegin(), tree.cend())) == tree.size(), "distance");
+}
+
+static void randomOperations() {
+    mt19937 random(7);
+    Tree tree;
+    Map reference;
+    for (int i = 0; i < 20000; i++) {
+        int key = int(random() % 2000);
+        switch (random() % 4) {
+            case 0:
+            case 1:
+                check(tree.insert(key, i) == reference.emplace(key, i).second, "insert");
+                break;
+            case 2: {
+                // erase through an iterator and check the one it returns
+                auto it = tree.find(key);
+                auto expected = reference.find(key);
+                check((it == tree.end()) == (expected == reference.end()), "find before erase");
+                if (it != tree.end()) {
+                    int next = keyAt(tree, tree.erase(it));
+                    check(next == keyAt(reference, reference.erase(expected)), "erase returns the next entry");
+                }
+                break;
+            }
+            default:
+                checkQueries(tree, reference, key);
+                break;
+        }
+        if (i % 2000 == 0) {
+            checkTraversals(tree, reference);
+        }
+    }
+    checkTraversals(tree, reference);
+    for (int key = -1; key <= 2001; key++) {
+        checkQueries(tree, reference, key);
+    }
+}
+
+// iterators stay valid across inserts and erases of other entries
+static void iteratorStability() {
+    Tree tree;
+    for (int key = 0; key < 100; key += 2) {
+        tree.insert(key, key);
+    }
+    auto held = tree.find(50);
+    for (int key = 1; key < 100; key += 2) {
+        tree.insert(key, key);
+    }
+    for (int key = 0; key < 50; key++) {
+        tree.remove(key);
+    }
+    check(held->first == 50 && held->second == 50, "held iterator survives other writes");
+    held->second = 500; // writable through a mutable iterator
+    check(tree.get(50) == 500, "write through iterator");
+    check(held == tree.begin(), "held entry is now the smallest");
+    tree.verify();
+}
+
+static void stringKeys() {
+    AVLTree<string, size_t> tree;
+    for (string key : {"pear", "apple", "fig", "kiwi", "banana"}) {
+        tree.insert(key, key.size());
+    }
+    // the transparent comparator finds string_view keys without building a string
+    check(tree.find(string_view("fig"))->second == 3, "transparent find");
+    check(tree.lower_bound(string_view("c"))->first == "fig", "transparent lower_bound");
+    check(tree.upper_bound(string_view("pear")) == tree.end(), "transparent upper_bound past the end");
+    check(tree.begin()->first == "apple" && tree.rbegin()->first == "pear", "string order");
+}
+
+int main() {
+    randomOperations();
+    iteratorStability();
+    stringKeys();
+    cout << "iterators: ok" << endl;
+    return 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for the range queries: findRange, the lazy range() view and
+forEachInRange with limits, early stops and reverse order, checked against
+std::map.
+ */
+#include "AVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <cstdint>
+#include <map>
+#include <random>
+#include <ranges>
+#include <string>
+#include <vector>
+using namespace std;
+
+using Tree = AVLTree<int, int>;
+using Map = map<int, int>;
+
+// entries of reference with keys in [low, high], in order
+static vector<pair<int, int> > expectedRange(const Map &reference, int low, int high) {
+    vector<pair<int, int> > entries;
+    if (low <= high) {
+        for (auto it = reference.lower_bound(low); it != reference.upper_bound(high); ++it) {
+            entries.emplace_back(it->first, it->second);
+        }
+    }
+    return entries;
+}
+
+static void checkRange(Tree &tree, const Map &reference, int low, int high) {
+    string what = "[" + to_string(low) + ", " + to_string(high) + "]";
+    vector<pair<int, int> > expected = expectedRange(reference, low, high);
+
+    vector<int> keys = tree.findRange(low, high);
+    check(keys.size() == expected.size(), what + ": findRange size");
+    for (size_t i = 0; i < keys.size(); i++) {
+        check(keys[i] == expected[i].first, what + ": findRange keys");
+    }
+
+    vector<pair<int, int> > viewed;
+    for (const auto &[key, value] : as_const(tree).range(low, high)) {
+        viewed.emplace_back(key, value);
+    }
+    check(viewed == expected, what + ": const range()");
+
+    // the view composes with the standard adaptors and stays in step backwards
+    viewed.clear();
+    for (const auto &[key, value] : tree.range(low, high) | views::reverse) {
+        viewed.emplace_back(key, value);
+    }
+    check(vector(expected.rbegin(), expected.rend()) == viewed, what + ": reversed range()");
+
+    viewed.clear();
+    size_t visited = tree.forEachInRange(low, high, [&viewed](const int &key, const int &value) {
+        viewed.emplace_back(key, value);
+    });
+    check(visited == expected.size() && viewed == expected, what + ": forEachInRange");
+
+    // limit and reverse together give the last few entries, highest first
+    size_t limit = 3;
+    viewed.clear();
+    visited = tree.forEachInRange(low, high, [&viewed](const int &key, const int &value) {
+        viewed.emplace_back(key, value);
+    }, limit, true);
+    size_t expectedCount = min(limit, expected.size());
+    check(visited == expectedCount, what + ": reverse limit count");
+    for (size_t i = 0; i < expectedCount; i++) {
+        check(viewed[i] == expected[expected.size() - 1 - i], what + ": reverse limit entries");
+    }
+
+    // a visitor returning false stops the walk after the entry it was given
+    size_t calls = 0;
+    visited = tree.forEachInRange(low, high, [&calls](const int &, const int &) {
+        return ++calls < 2;
+    });
+    check(visited == min<size_t>(2, expected.size()) && calls == visited, what + ": early stop");
+}
+
+static void randomRanges() {
+    mt19937 random(8);
+    Tree tree;
+    Map reference;
+    for (int i = 0; i < 3000; i++) {
+        int key = int(random() % 10000);
+        tree.insert(key, i);
+        reference.emplace(key, i);
+        if (i % 7 == 0) {
+            int gone = int(random() % 10000);
+            tree.remove(gone);
+            reference.erase(gone);
+        }
+    }
+    checkTree(tree, reference, "random build");
+    for (int i = 0; i < 500; i++) {
+        int low = int(random() % 10200) - 100;
+        int high = low + int(random() % 400);
+        checkRange(tree, reference, low, high);
+    }
+    // whole tree, single keys, empty and crossed bounds
+    checkRange(tree, reference, INT32_MIN, INT32_MAX);
+    checkRange(tree, reference, reference.begin()->first, reference.begin()->first);
+    checkRange(tree, reference, 20000, 30000);
+    checkRange(tree, reference, 500, 100);
+}
+
+static void emptyTree() {
+    Tree tree;
+    Map reference;
+    checkRange(tree, reference, 0, 100);
+    check(tree.range(0, 100).empty(), "empty tree range");
+}
+
+// the view writes through to the tree's values
+static void writeThroughView() {
+    Tree tree;
+    Map reference;
+    for (int key = 0; key < 100; key++) {
+        tree.insert(key, key);
+        reference.emplace(key, key);
+    }
+    for (auto &[key, value] : tree.range(20, 29)) {
+        value = -key;
+        reference[key] = -key;
+    }
+    checkTree(tree, reference, "write through range()");
+}
+
+int main() {
+    randomRanges();
+    emptyTree();
+    writeThroughView();
+    cout << "ranges: ok" << endl;
+    return 0;
+}
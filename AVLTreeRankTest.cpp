@@ -0,0 +1,98 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for the order statistics: rank, select and countRange, checked
+against std::map while subtree sizes are kept up through inserts, erases and
+rotations.
+ */
+#include "AVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+using namespace std;
+
+using Tree = AVLTree<int, int>;
+using Map = map<int, int>;
+
+static void checkOrderStatistics(const Tree &tree, const Map &reference, int key) {
+    string what = "key " + to_string(key);
+    size_t expectedRank = size_t(distance(reference.begin(), reference.lower_bound(key)));
+    check(tree.rank(key) == expectedRank, what + ": rank");
+    auto selected = tree.select(expectedRank);
+    auto expected = reference.lower_bound(key);
+    check(expected == reference.end() ? selected == tree.end() : selected->first == expected->first,
+          what + ": select(rank)");
+}
+
+static void checkCount(const Tree &tree, const Map &reference, int low, int high) {
+    size_t expected = 0;
+    if (low <= high) {
+        expected = size_t(distance(reference.lower_bound(low), reference.upper_bound(high)));
+    }
+    check(tree.countRange(low, high) == expected,
+          "countRange [" + to_string(low) + ", " + to_string(high) + "]");
+}
+
+static void randomOperations() {
+    mt19937 random(9);
+    Tree tree;
+    Map reference;
+    for (int i = 0; i < 20000; i++) {
+        int key = int(random() % 3000);
+        if (random() % 3 == 0) {
+            check(tree.remove(key) == (reference.erase(key) == 1), "remove");
+        } else {
+            check(tree.insert(key, i) == reference.emplace(key, i).second, "insert");
+        }
+        checkOrderStatistics(tree, reference, int(random() % 3100) - 50);
+        int low = int(random() % 3100) - 50;
+        checkCount(tree, reference, low, low + int(random() % 500) - 50);
+        if (i % 2500 == 0) {
+            checkTree(tree, reference, "random operations");
+        }
+    }
+    checkTree(tree, reference, "random operations");
+
+    // select walks every position and agrees with iteration order
+    size_t position = 0;
+    for (const auto &[key, value] : reference) {
+        auto selected = tree.select(position++);
+        check(selected != tree.end() && selected->first == key && selected->second == value, "select every position");
+    }
+    check(tree.select(reference.size()) == tree.end(), "select past the end");
+    check(tree.countRange(INT32_MIN, INT32_MAX) == reference.size(), "countRange over everything");
+}
+
+static void emptyTree() {
+    const Tree tree;
+    check(tree.rank(5) == 0, "empty rank");
+    check(tree.select(0) == tree.end(), "empty select");
+    check(tree.countRange(0, 10) == 0, "empty countRange");
+}
+
+static void stringKeys() {
+    AVLTree<string, size_t> tree;
+    for (string key : {"delta", "alpha", "echo", "charlie", "bravo"}) {
+        tree.insert(key, key.size());
+    }
+    check(tree.rank(string_view("charlie")) == 2, "transparent rank");
+    check(tree.countRange(string_view("b"), string_view("d")) == 2, "transparent countRange");
+    check(as_const(tree).select(4)->first == "echo", "const select");
+}
+
+int main() {
+    randomOperations();
+    emptyTree();
+    stringKeys();
+    cout << "order statistics: ok" << endl;
+    return 0;
+}
@@ -0,0 +1,232 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for AVLTree::save/load and FrozenAVLTree: round trips checked
+against std::map, and truncated, reordered or otherwise corrupt files that must
+be refused without touching the tree. Files go to a scratch directory under
+the system temp directory.
+ */
+#include "AVLTree.h"
+#include "FrozenAVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+using namespace std;
+namespace fs = std::filesystem;
+
+using Tree = AVLTree<string, size_t>;
+using Map = map<string, size_t>;
+
+static string readFile(const fs::path &path) {
+    ifstream in(path, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+static void writeFile(const fs::path &path, const string &bytes) {
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(bytes.data(), streamsize(bytes.size()));
+}
+
+static void randomEntries(Tree &tree, Map &reference, size_t count, unsigned seed) {
+    mt19937 random(seed);
+    for (size_t i = 0; i < count; i++) {
+        string key(random() % 24, '\0');
+        for (char &c : key) {
+            c = char(random() % 256); // any bytes, zeros included
+        }
+        tree.insert(key, i);
+        reference.emplace(key, i);
+    }
+}
+
+static void roundTrips(const fs::path &directory) {
+    for (size_t count : {0, 1, 2, 1000}) {
+        Tree tree;
+        Map reference;
+        randomEntries(tree, reference, count, unsigned(count));
+        string what = to_string(count) + " entries";
+
+        fs::path path = directory / "tree.avl";
+        tree.save(path.string());
+        check(!fs::exists(path.string() + ".tmp"), what + ": no partial file left behind");
+        Tree loaded;
+        loaded.insert("replaced", 1);
+        loaded.load(path.string());
+        checkTree(loaded, reference, what + ": file round trip");
+        size_t minimal = reference.empty() ? 0 : size_t(bit_width(reference.size())) - 1;
+        check(loaded.getHeight() == minimal, what + ": loaded perfectly balanced");
+
+        stringstream stream;
+        tree.save(stream);
+        Tree streamed;
+        streamed.load(stream);
+        checkTree(streamed, reference, what + ": stream round trip");
+    }
+
+    AVLTree<long, double> numbers;
+    map<long, double> expected;
+    for (long key = -500; key < 500; key += 3) {
+        numbers.insert(key, key * 0.5);
+        expected.emplace(key, key * 0.5);
+    }
+    stringstream stream;
+    numbers.save(stream);
+    AVLTree<long, double> loaded;
+    loaded.load(stream);
+    checkTree(loaded, expected, "fixed-size keys and values");
+}
+
+// a refused file leaves the tree it was loaded into as it was
+static void checkRefused(const string &bytes, const Tree &before, const Map &reference, const string &what) {
+    Tree tree(before);
+    stringstream stream(bytes);
+    check(throws<runtime_error>([&] { tree.load(stream); }), what + ": refused");
+    checkTree(tree, reference, what + ": tree untouched");
+}
+
+static void corruptSaves(const fs::path &directory) {
+    Tree saved;
+    Map savedReference;
+    randomEntries(saved, savedReference, 40, 20);
+    stringstream stream;
+    saved.save(stream);
+    string good = stream.str();
+
+    Tree before;
+    Map reference;
+    randomEntries(before, reference, 10, 21);
+
+    // every proper prefix is a truncated file
+    for (size_t length = 0; length < good.size(); length++) {
+        checkRefused(good.substr(0, length), before, reference, "truncated to " + to_string(length));
+    }
+    string badMagic = good;
+    badMagic[0] ^= 1;
+    checkRefused(badMagic, before, reference, "bad magic");
+    string otherByteOrder = good;
+    swap(otherByteOrder[8], otherByteOrder[11]);
+    checkRefused(otherByteOrder, before, reference, "other byte order");
+    string hugeCount = good;
+    hugeCount.replace(12, 8, string(8, '\x7f'));
+    checkRefused(hugeCount, before, reference, "entry count past the end");
+
+    // keys out of order and repeated keys are corruption too
+    for (auto [first, second] : {pair<string, string>{"b", "a"}, pair<string, string>{"a", "a"}}) {
+        stringstream crafted;
+        Tree().save(crafted);
+        string bytes = crafted.str();
+        bytes.replace(12, 8, string("\x02\0\0\0\0\0\0\0", 8));
+        stringstream entries;
+        for (const string &key : {first, second}) {
+            BinaryCodec<string>::write(entries, key);
+            BinaryCodec<size_t>::write(entries, 7);
+        }
+        checkRefused(bytes + entries.str(), before, reference, "keys " + first + ", " + second);
+    }
+
+    Tree tree(before);
+    check(throws<runtime_error>([&] { tree.load((directory / "missing.avl").string()); }), "missing file");
+    checkTree(tree, reference, "missing file: tree untouched");
+}
+
+static void frozenTrees(const fs::path &directory) {
+    Tree tree;
+    Map reference;
+    randomEntries(tree, reference, 3000, 22);
+    fs::path path = directory / "tree.frozen";
+    FrozenAVLTree<>::write(path.string(), tree);
+
+    FrozenAVLTree<> frozen(path.string());
+    check(frozen.size() == reference.size() && !frozen.empty(), "frozen size");
+    mt19937 random(23);
+    for (const auto &[key, value] : reference) {
+        check(frozen.get(key) == value && frozen.contains(key), "frozen lookup");
+        string missing = key + char(random() % 256);
+        check(frozen.contains(missing) == reference.contains(missing), "frozen miss");
+    }
+    auto low = next(reference.begin(), 100), high = next(reference.begin(), 400);
+    vector<string> expected;
+    for (auto it = low; it != next(high); ++it) {
+        expected.push_back(it->first);
+    }
+    check(frozen.findRange(low->first, high->first) == expected, "frozen findRange");
+    size_t visits = frozen.forEachInRange(low->first, high->first, [](string_view, size_t) {}, 10);
+    check(visits == 10, "frozen forEachInRange limit");
+
+    // fixed-size keys, and an empty tree
+    map<long, long> numbers;
+    for (long key = 0; key < 1000; key++) {
+        numbers.emplace(key * 7, -key);
+    }
+    FrozenAVLTree<long, long>::write((directory / "numbers.frozen").string(), numbers);
+    FrozenAVLTree<long, long> frozenNumbers((directory / "numbers.frozen").string());
+    for (long key = -1; key < 7001; key++) {
+        auto found = numbers.find(key);
+        check(frozenNumbers.get(key) == (found == numbers.end() ? nullopt : optional(found->second)),
+              "frozen fixed-size lookup");
+    }
+    FrozenAVLTree<>::write((directory / "empty.frozen").string(), Map());
+    FrozenAVLTree<> empty((directory / "empty.frozen").string());
+    check(empty.empty() && !empty.get("a") && empty.findRange("", "z").empty(), "frozen empty tree");
+
+    check(throws<invalid_argument>([&] {
+        FrozenAVLTree<long, long>::write((directory / "bad.frozen").string(),
+                                         vector<pair<long, long> >{{2, 0}, {1, 0}});
+    }), "frozen write refuses unsorted input");
+}
+
+// corrupt or mismatched headers fail to open
+static void corruptFrozen(const fs::path &directory) {
+    fs::path path = directory / "tree.frozen";
+    string good = readFile(path);
+    fs::path bad = directory / "bad.frozen";
+    auto refused = [&](const string &bytes, const string &what) {
+        writeFile(bad, bytes);
+        check(throws<runtime_error>([&] { FrozenAVLTree<> frozen(bad.string()); }), "frozen " + what);
+    };
+    refused("", "empty file");
+    refused(good.substr(0, 40), "header only partly there");
+    refused(good.substr(0, good.size() - 1), "truncated");
+    refused(good + "x", "trailing bytes");
+    string badMagic = good;
+    badMagic[7] = '9';
+    refused(badMagic, "bad magic");
+    string otherByteOrder = good;
+    swap(otherByteOrder[8], otherByteOrder[11]);
+    refused(otherByteOrder, "other byte order");
+    string moreEntries = good;
+    moreEntries[24] ^= 1; // low byte of the entry count
+    refused(moreEntries, "entry count changed");
+    string offsets = good;
+    offsets[32] ^= 8; // index offset
+    refused(offsets, "section offset changed");
+    check(throws<runtime_error>([&] { FrozenAVLTree<string, uint32_t> frozen(path.string()); }),
+          "frozen other value type");
+    check(throws<runtime_error>([&] { FrozenAVLTree<> frozen((directory / "missing").string()); }),
+          "frozen missing file");
+}
+
+int main() {
+    fs::path directory = fs::temp_directory_path() / ("avltree-serialization-" + to_string(getpid()));
+    fs::create_directories(directory);
+    roundTrips(directory);
+    corruptSaves(directory);
+    frozenTrees(directory);
+    corruptFrozen(directory);
+    fs::remove_all(directory);
+    cout << "serialization: ok" << endl;
+    return 0;
+}
@@ -0,0 +1,225 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for unionWith, intersect and difference, checked against std::map:
+random sets of very different sizes, empty and self operands, pooled trees that
+cannot share nodes, and a comparator that throws part way through.
+ */
+#include "AVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+using namespace std;
+
+using Tree = AVLTree<int, int>;
+using Map = map<int, int>;
+
+enum class Op { unite, intersect, subtract };
+
+static const char *name(Op op) {
+    return op == Op::unite ? "unionWith" : op == Op::intersect ? "intersect" : "difference";
+}
+
+template<typename T>
+static void apply(Op op, T &tree, T &other) {
+    if (op == Op::unite) {
+        tree.unionWith(other);
+    } else if (op == Op::intersect) {
+        tree.intersect(other);
+    } else {
+        tree.difference(other);
+    }
+}
+
+// what op leaves in mine; shared keys keep mine's value
+static Map expected(Op op, const Map &mine, const Map &theirs) {
+    Map result;
+    for (const auto &[key, value] : mine) {
+        bool shared = theirs.contains(key);
+        if (op == Op::unite || shared == (op == Op::intersect)) {
+            result.emplace(key, value);
+        }
+    }
+    if (op == Op::unite) {
+        result.insert(theirs.begin(), theirs.end());
+    }
+    return result;
+}
+
+template<typename T>
+static void fill(T &tree, Map &reference, mt19937 &random, size_t count, int range, int sign) {
+    while (reference.size() < count) {
+        int key = int(random() % range);
+        if (reference.emplace(key, sign * key).second) {
+            tree.insert(key, sign * key);
+        }
+    }
+}
+
+// random sets from a handful of entries up to sizes far apart
+static void randomSets() {
+    mt19937 random(25);
+    const size_t sizes[][2] = {{0, 0}, {0, 300}, {300, 0}, {1, 1}, {10, 5000}, {5000, 10}, {2000, 2000}, {7000, 700}};
+    for (Op op : {Op::unite, Op::intersect, Op::subtract}) {
+        for (auto [mineCount, theirsCount] : sizes) {
+            Tree tree, other;
+            Map mine, theirs;
+            int range = int(2 * (mineCount + theirsCount) + 1);
+            fill(tree, mine, random, mineCount, range, 1);
+            fill(other, theirs, random, theirsCount, range, -1);
+            apply(op, tree, other);
+            string what = string(name(op)) + " of " + to_string(mineCount) + " and " + to_string(theirsCount);
+            checkTree(tree, expected(op, mine, theirs), what);
+            checkTree(other, Map(), what + ": other");
+        }
+    }
+}
+
+// disjoint and identical key sets, and a tree combined with itself
+static void edgeCases() {
+    for (Op op : {Op::unite, Op::intersect, Op::subtract}) {
+        Tree tree, other;
+        Map mine, theirs;
+        for (int key = 0; key < 1000; key++) {
+            (key % 2 ? tree : other).insert(key, key);
+            (key % 2 ? mine : theirs).emplace(key, key);
+        }
+        apply(op, tree, other);
+        checkTree(tree, expected(op, mine, theirs), string(name(op)) + " of disjoint sets");
+
+        Tree same, copy;
+        Map reference;
+        for (int key = 0; key < 1000; key++) {
+            same.insert(key, key);
+            copy.insert(key, -key);
+            reference.emplace(key, key);
+        }
+        apply(op, same, copy);
+        checkTree(same, op == Op::subtract ? Map() : reference, string(name(op)) + " of equal key sets");
+
+        Tree self;
+        for (int key = 0; key < 100; key++) {
+            self.insert(key, key);
+        }
+        Map selfReference(reference.begin(), reference.find(100));
+        apply(op, self, self);
+        checkTree(self, op == Op::subtract ? Map() : selfReference, string(name(op)) + " with itself");
+    }
+}
+
+// trees on different pools cannot relink nodes between them
+static void pooledTrees() {
+    mt19937 random(26);
+    for (Op op : {Op::unite, Op::intersect, Op::subtract}) {
+        PooledAVLTree<int, int> tree, other;
+        Map mine, theirs;
+        fill(tree, mine, random, 1500, 4000, 1);
+        fill(other, theirs, random, 1500, 4000, -1);
+        apply(op, tree, other);
+        checkTree(tree, expected(op, mine, theirs), string("pooled ") + name(op));
+        checkTree(other, Map(), string("pooled ") + name(op) + ": other");
+    }
+}
+
+struct ThrowingLess {
+    static inline long budget = -1; // negative: never throw
+
+    bool operator()(int a, int b) const {
+        if (budget == 0) {
+            throw runtime_error("comparator failed");
+        }
+        if (budget > 0) {
+            budget--;
+        }
+        return a < b;
+    }
+};
+
+// counts the nodes alive across every tree using it
+inline atomic<long> liveNodes{0};
+
+template<typename T>
+struct CountingAllocator {
+    using value_type = T;
+    using is_always_equal = true_type;
+
+    CountingAllocator() = default;
+
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U> &) {}
+
+    T *allocate(size_t n) {
+        T *memory = allocator<T>().allocate(n);
+        liveNodes += long(n);
+        return memory;
+    }
+
+    void deallocate(T *memory, size_t n) {
+        liveNodes -= long(n);
+        allocator<T>().deallocate(memory, n);
+    }
+
+    template<typename U>
+    bool operator==(const CountingAllocator<U> &) const {
+        return true;
+    }
+};
+
+// a comparator throwing part way through leaves both trees empty and frees every node
+static void throwingComparator() {
+    using Throwing = AVLTree<int, int, ThrowingLess, CountingAllocator<pair<const int, int> > >;
+    for (Op op : {Op::unite, Op::intersect, Op::subtract}) {
+        size_t throwsSeen = 0;
+        bool threw = false;
+        for (long budget = 0; budget < 20000; budget += budget / 8 + 1) {
+            Throwing tree, other;
+            Map mine, theirs;
+            for (int key = 0; key < 600; key++) {
+                if (key % 3 != 0) {
+                    tree.insert(key, key);
+                    mine.emplace(key, key);
+                }
+                if (key % 2 == 0) {
+                    other.insert(key, -key);
+                    theirs.emplace(key, -key);
+                }
+            }
+            string what = string(name(op)) + " with " + to_string(budget) + " comparisons";
+            ThrowingLess::budget = budget;
+            threw = false;
+            try {
+                apply(op, tree, other);
+                ThrowingLess::budget = -1;
+                checkTree(tree, expected(op, mine, theirs), what);
+            } catch (const runtime_error &) {
+                ThrowingLess::budget = -1;
+                throwsSeen++;
+                threw = true;
+                checkTree(tree, Map(), what + ", threw");
+                checkTree(other, Map(), what + ", threw: other");
+                check(liveNodes == 0, what + ", threw: every node freed");
+            }
+            checkTree(other, Map(), what + ": other");
+        }
+        check(throwsSeen > 0 && !threw, string(name(op)) + ": the comparator threw at every depth and then stopped");
+    }
+    check(liveNodes == 0, "no node outlives its tree");
+}
+
+int main() {
+    randomSets();
+    edgeCases();
+    pooledTrees();
+    throwingComparator();
+    cout << "set operations: ok" << endl;
+    return 0;
+}
@@ -0,0 +1,230 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for split, join and eraseRange, checked against std::map: random
+cuts and rejoins, joins of trees of very different heights, overlapping joins
+that must be refused, pooled trees that cannot share nodes, and range erases.
+ */
+#include "AVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <cstdint>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+using namespace std;
+
+using Tree = AVLTree<int, int>;
+using Map = map<int, int>;
+
+static void fill(Tree &tree, Map &reference, int low, int high, int step) {
+    for (int key = low; key < high; key += step) {
+        tree.insert(key, -key);
+        reference.emplace(key, -key);
+    }
+}
+
+// splits at random keys, present or not, and joins the halves back
+static void splitAndJoin() {
+    mt19937 random(21);
+    Tree tree;
+    Map reference;
+    for (int i = 0; i < 5000; i++) {
+        int key = int(random() % 20000);
+        tree.insert(key, i);
+        reference.emplace(key, i);
+    }
+    for (int round = 0; round < 300; round++) {
+        int cut = int(random() % 20200) - 100;
+        Tree upper = tree.split(cut);
+        Map lowerReference(reference.begin(), reference.lower_bound(cut));
+        Map upperReference(reference.lower_bound(cut), reference.end());
+        string what = "split at " + to_string(cut);
+        checkTree(tree, lowerReference, what + ": lower half");
+        checkTree(upper, upperReference, what + ": upper half");
+        // the halves are ordinary trees until joined again
+        if (round % 10 == 0) {
+            tree.insert(cut - 100000, 0);
+            tree.remove(cut - 100000);
+        }
+        tree.join(upper);
+        check(upper.empty(), what + ": join leaves other empty");
+        checkTree(tree, reference, what + ": joined back");
+    }
+    // cutting below everything and past everything
+    Tree all = tree.split(INT32_MIN);
+    check(tree.empty(), "split below everything");
+    checkTree(all, reference, "split below everything: upper");
+    Tree none = all.split(INT32_MAX);
+    check(none.empty(), "split past everything");
+    checkTree(all, reference, "split past everything: lower");
+}
+
+// a much taller tree joined to a tiny one, both ways round
+static void unevenJoins() {
+    for (int small : {0, 1, 2, 5}) {
+        Tree big, little;
+        Map reference;
+        fill(big, reference, 0, 40000, 1);
+        fill(little, reference, 50000, 50000 + small, 1);
+        big.join(little);
+        checkTree(big, reference, "tall then short, " + to_string(small));
+
+        Tree left, right;
+        reference.clear();
+        fill(left, reference, -small, 0, 1);
+        fill(right, reference, 0, 40000, 1);
+        left.join(right);
+        checkTree(left, reference, "short then tall, " + to_string(small));
+    }
+}
+
+// overlapping keys are refused and both trees stay as they were
+static void overlappingJoins() {
+    Tree tree, other;
+    Map reference, otherReference;
+    fill(tree, reference, 0, 100, 2);
+    fill(other, otherReference, 98, 200, 2);
+    check(throws<invalid_argument>([&] { tree.join(other); }), "shared key refused");
+    Tree interleaved;
+    Map interleavedReference;
+    fill(interleaved, interleavedReference, 51, 60, 2);
+    check(throws<invalid_argument>([&] { tree.join(interleaved); }), "interleaved keys refused");
+    checkTree(tree, reference, "refused join: this");
+    checkTree(other, otherReference, "refused join: other");
+    checkTree(interleaved, interleavedReference, "refused join: interleaved");
+    tree.join(tree);
+    checkTree(tree, reference, "join with itself");
+}
+
+// trees on different pools cannot relink nodes, so join moves the entries
+static void pooledTrees() {
+    PooledAVLTree<int, int> tree, other;
+    Map reference;
+    for (int key = 0; key < 3000; key++) {
+        (key < 1500 ? tree : other).insert(key, key);
+        reference.emplace(key, key);
+    }
+    tree.join(other);
+    check(other.empty(), "pooled join empties other");
+    checkTree(tree, reference, "pooled join");
+    auto upper = tree.split(1000);
+    check(upper.get_allocator() == tree.get_allocator(), "split half shares the pool");
+    checkTree(upper, Map(reference.lower_bound(1000), reference.end()), "pooled split");
+}
+
+static void eraseRanges() {
+    mt19937 random(22);
+    Tree tree;
+    Map reference;
+    fill(tree, reference, 0, 30000, 1);
+    for (int round = 0; round < 300; round++) {
+        int low = int(random() % 31000) - 500;
+        int high = low + int(random() % 2000) - 100; // sometimes crossed
+        size_t expected = 0;
+        if (low <= high) {
+            auto first = reference.lower_bound(low), last = reference.upper_bound(high);
+            expected = size_t(distance(first, last));
+            reference.erase(first, last);
+        }
+        string what = "eraseRange [" + to_string(low) + ", " + to_string(high) + "]";
+        check(tree.eraseRange(low, high) == expected, what + ": count");
+        if (round % 10 == 0) {
+            checkTree(tree, reference, what);
+        }
+        if (round % 50 == 0) {
+            fill(tree, reference, low, low + 500, 1); // put some back
+        }
+    }
+    checkTree(tree, reference, "after eraseRange");
+    check(tree.eraseRange(INT32_MIN, INT32_MAX) == reference.size() && tree.empty(), "eraseRange everything");
+    check(tree.eraseRange(0, 10) == 0, "eraseRange on an empty tree");
+}
+
+// std::less that throws once a budget of calls runs out
+struct ThrowingLess {
+    static inline long budget = -1; // negative: never throw
+
+    bool operator()(int a, int b) const {
+        if (budget == 0) {
+            throw runtime_error("comparator failed");
+        }
+        if (budget > 0) {
+            budget--;
+        }
+        return a < b;
+    }
+};
+
+// a comparator throwing part way through split or eraseRange leaves every entry in place
+static void throwingComparator() {
+    using Throwing = AVLTree<int, int, ThrowingLess>;
+    Throwing tree;
+    Map reference;
+    for (int key = 0; key < 1000; key++) {
+        tree.insert(key, key);
+        reference.emplace(key, key);
+    }
+    size_t splitThrows = 0, eraseThrows = 0;
+    for (long budget = 0; budget < 40; budget++) {
+        ThrowingLess::budget = budget;
+        bool threw = false;
+        try {
+            Throwing upper = tree.split(613);
+            ThrowingLess::budget = -1;
+            tree.join(upper);
+        } catch (const runtime_error &) {
+            threw = true;
+            splitThrows++;
+        }
+        ThrowingLess::budget = -1;
+        checkTree(tree, reference, "split with " + to_string(budget) + " comparisons" + (threw ? ", threw" : ""));
+
+        ThrowingLess::budget = budget;
+        try {
+            size_t erased = tree.eraseRange(200, 260);
+            ThrowingLess::budget = -1;
+            for (int key = 200; key <= 260; key++) {
+                tree.insert(key, key); // put them back
+            }
+            check(erased == 61, "eraseRange count");
+        } catch (const runtime_error &) {
+            eraseThrows++;
+        }
+        ThrowingLess::budget = -1;
+        checkTree(tree, reference, "eraseRange with " + to_string(budget) + " comparisons");
+    }
+    check(splitThrows > 0 && splitThrows < 40 && eraseThrows > 0 && eraseThrows < 40,
+          "the comparator threw at every depth and then stopped");
+}
+
+static void stringKeys() {
+    AVLTree<string, size_t> tree;
+    for (string key : {"ant", "bee", "cat", "dog", "eel", "fox"}) {
+        tree.insert(key, key.size());
+    }
+    auto upper = tree.split(string_view("cow"));
+    check(tree.size() == 3 && upper.begin()->first == "dog", "transparent split");
+    check(upper.eraseRange(string_view("d"), string_view("e")) == 1, "transparent eraseRange");
+    tree.join(upper);
+    check(tree.size() == 5, "string join");
+    tree.verify();
+}
+
+int main() {
+    splitAndJoin();
+    unevenJoins();
+    overlappingJoins();
+    pooledTrees();
+    eraseRanges();
+    throwingComparator();
+    stringKeys();
+    cout << "split/join: ok" << endl;
+    return 0;
+}
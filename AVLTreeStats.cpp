@@ -0,0 +1,70 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+#include "AVLTreeStats.h"
+#include <algorithm>
+#include <bit>
+#include <sstream>
+
+void LatencyHistogram::record(std::uint64_t nanoseconds) {
+    size_t bucket = std::min<size_t>(std::bit_width(nanoseconds), bucketCount - 1);
+    AVLTreeStats::add(counts[bucket]);
+    AVLTreeStats::add(samples);
+    AVLTreeStats::add(total, nanoseconds);
+}
+
+std::uint64_t LatencyHistogram::percentile(double p) const {
+    if (samples == 0) {
+        return 0;
+    }
+    // the sample at this rank (1-based) decides the bucket
+    std::uint64_t rank = std::max<std::uint64_t>(1, std::uint64_t(p / 100.0 * double(samples) + 0.5));
+    std::uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < bucketCount; bucket++) {
+        seen += counts[bucket];
+        if (seen >= rank) {
+            return bucket == 0 ? 0 : (std::uint64_t(1) << bucket) - 1;
+        }
+    }
+    return (std::uint64_t(1) << (bucketCount - 1)) - 1;
+}
+
+void LatencyHistogram::reset() {
+    counts.fill(0);
+    samples = 0;
+    total = 0;
+}
+
+void AVLTreeStats::reset() {
+    *this = AVLTreeStats();
+}
+
+std::string AVLTreeStats::toString() const {
+    std::ostringstream out;
+    out << "comparisons " << comparisons << '\n'
+        << "rotations.left " << rotationsLeft << '\n'
+        << "rotations.right " << rotationsRight << '\n'
+        << "rotations.left_right " << rotationsLeftRight << '\n'
+        << "rotations.right_left " << rotationsRightLeft << '\n'
+        << "retrace.steps " << retraceSteps << '\n'
+        << "retrace.max_depth " << maxRetraceDepth << '\n'
+        << "nodes.allocated " << allocations << '\n'
+        << "nodes.freed " << deallocations << '\n';
+    const std::pair<const char *, const LatencyHistogram *> operations[] = {
+        {"insert", &insertLatency}, {"remove", &removeLatency}, {"get", &getLatency},
+        {"contains", &containsLatency}, {"findRange", &findRangeLatency}
+    };
+    for (const auto &[name, histogram] : operations) {
+        std::uint64_t count = histogram->count();
+        out << "latency." << name << " count " << count
+            << " mean_ns " << (count ? histogram->totalNanoseconds() / count : 0)
+            << " p50_ns " << histogram->percentile(50)
+            << " p99_ns " << histogram->percentile(99)
+            << " p100_ns " << histogram->percentile(100) << '\n';
+    }
+    return out.str();
+}
@@ -0,0 +1,128 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * AVLTreeStats.h
+ */
+
+#ifndef AVLTREESTATS_H
+#define AVLTREESTATS_H
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Instrumentation is compiled in only when AVLTREE_STATS is 1 (the CMake
+// option of the same name). Otherwise the hooks below expand to nothing and
+// AVLTree carries no stats member, so a normal build pays nothing at all.
+#ifndef AVLTREE_STATS
+#define AVLTREE_STATS 0
+#endif
+
+// Latencies in power-of-two nanosecond buckets: bucket 0 counts 0 ns and
+// bucket i counts [2^(i-1), 2^i) ns, the last one everything above.
+class LatencyHistogram {
+public:
+    static constexpr size_t bucketCount = 40; // the last bucket starts near 4.6 minutes
+
+    void record(std::uint64_t nanoseconds);
+
+    std::uint64_t count() const { return samples; }
+
+    std::uint64_t totalNanoseconds() const { return total; }
+
+    // upper edge of the bucket holding the p-th percentile (0 to 100), 0 if empty
+    std::uint64_t percentile(double p) const;
+
+    const std::array<std::uint64_t, bucketCount> &buckets() const { return counts; }
+
+    void reset();
+
+private:
+    std::array<std::uint64_t, bucketCount> counts{};
+    std::uint64_t samples = 0;
+    std::uint64_t total = 0;
+};
+
+// Per-tree counters, a plain struct so it can be copied out and exported.
+// Updates are relaxed loads and stores rather than atomic increments: a tree
+// read from several threads at once may undercount, but never races.
+struct AVLTreeStats {
+    std::uint64_t comparisons = 0; // key comparisons while descending
+    std::uint64_t rotationsLeft = 0; // single rotations
+    std::uint64_t rotationsRight = 0;
+    std::uint64_t rotationsLeftRight = 0; // double rotations, left child first
+    std::uint64_t rotationsRightLeft = 0;
+    std::uint64_t retraceSteps = 0; // nodes rebalanced on the way back up
+    std::uint64_t maxRetraceDepth = 0; // longest single retrace
+    std::uint64_t allocations = 0; // nodes created
+    std::uint64_t deallocations = 0; // nodes destroyed one by one
+
+    LatencyHistogram insertLatency;
+    LatencyHistogram removeLatency;
+    LatencyHistogram getLatency;
+    LatencyHistogram containsLatency;
+    LatencyHistogram findRangeLatency;
+
+    void reset();
+
+    // one "name value" line per counter and a count/mean/p50/p99/max line per
+    // operation
+    std::string toString() const;
+
+    friend std::ostream &operator<<(std::ostream &os, const AVLTreeStats &stats) {
+        return os << stats.toString();
+    }
+
+    static void add(std::uint64_t &counter, std::uint64_t amount = 1) {
+        std::atomic_ref<std::uint64_t> ref(counter);
+        ref.store(ref.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static void raise(std::uint64_t &counter, std::uint64_t value) {
+        std::atomic_ref<std::uint64_t> ref(counter);
+        if (value > ref.load(std::memory_order_relaxed)) {
+            ref.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    // records the time from construction to destruction into a histogram
+    class Timer {
+    public:
+        explicit Timer(LatencyHistogram &histogram)
+            : histogram(histogram), start(std::chrono::steady_clock::now()) {
+        }
+
+        Timer(const Timer &) = delete;
+
+        Timer &operator=(const Timer &) = delete;
+
+        ~Timer() {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            histogram.record(std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+
+    private:
+        LatencyHistogram &histogram;
+        std::chrono::steady_clock::time_point start;
+    };
+};
+
+#if AVLTREE_STATS
+#define AVLTREE_COUNT(counter) AVLTreeStats::add(treeStats.counter)
+#define AVLTREE_COUNT_MAX(counter, value) AVLTreeStats::raise(treeStats.counter, value)
+#define AVLTREE_TIME(histogram) AVLTreeStats::Timer avlTreeTimer(treeStats.histogram)
+#else
+#define AVLTREE_COUNT(counter) ((void) 0)
+#define AVLTREE_COUNT_MAX(counter, value) ((void) 0)
+#define AVLTREE_TIME(histogram) ((void) 0)
+#endif
+
+#endif //AVLTREESTATS_H
@@ -0,0 +1,119 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for the AVLTREE_STATS instrumentation. CMakeLists.txt compiles this
+file with AVLTREE_STATS=1 whatever the option says, so the counters are tested
+in every build; it only instantiates trees the library does not, which keeps
+the two layouts apart.
+ */
+#include "AVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <map>
+#include <random>
+#include <string>
+using namespace std;
+
+static_assert(AVLTREE_STATS, "AVLTreeStatsTest must be compiled with AVLTREE_STATS=1");
+
+using Tree = AVLTree<long, long>;
+
+// each rebalancing case is counted under its own name
+static void rotationKinds() {
+    struct Case {
+        long first, second, third;
+        uint64_t AVLTreeStats::*counter;
+        const char *name;
+    };
+    const Case cases[] = {
+        {1, 2, 3, &AVLTreeStats::rotationsLeft, "left"},
+        {3, 2, 1, &AVLTreeStats::rotationsRight, "right"},
+        {3, 1, 2, &AVLTreeStats::rotationsLeftRight, "left-right"},
+        {1, 3, 2, &AVLTreeStats::rotationsRightLeft, "right-left"},
+    };
+    for (const Case &c : cases) {
+        Tree tree;
+        for (long key : {c.first, c.second, c.third}) {
+            tree.insert(key, key);
+        }
+        const AVLTreeStats &stats = tree.stats();
+        uint64_t total = stats.rotationsLeft + stats.rotationsRight + stats.rotationsLeftRight +
+                         stats.rotationsRightLeft;
+        check(stats.*c.counter == 1 && total == 1, string(c.name) + " rotation counted once");
+        tree.verify();
+    }
+}
+
+static void operationCounters() {
+    mt19937 random(19);
+    Tree tree;
+    map<long, long> reference;
+    for (long i = 0; i < 5000; i++) {
+        long key = long(random() % 4000);
+        tree.insert(key, i);
+        reference.emplace(key, i);
+    }
+    checkTree(tree, reference, "random inserts");
+    const AVLTreeStats &stats = tree.stats();
+    check(stats.allocations == reference.size(), "one allocation per inserted node");
+    check(stats.insertLatency.count() == 5000, "every insert timed, duplicates included");
+    check(stats.comparisons > 0 && stats.retraceSteps > 0, "descents and retraces counted");
+    check(stats.maxRetraceDepth > 0 && stats.maxRetraceDepth <= tree.getHeight() + 1, "retrace depth within height");
+
+    size_t removed = 0;
+    for (long key = 0; key < 4000; key += 2) {
+        removed += tree.remove(key);
+        reference.erase(key);
+    }
+    checkTree(tree, reference, "after removes");
+    check(stats.deallocations == removed, "one deallocation per removed node");
+    check(stats.removeLatency.count() == 2000, "every remove timed");
+
+    tree.get(1);
+    tree.contains(1);
+    tree.contains(2);
+    tree.findRange(0, 100);
+    check(stats.getLatency.count() == 1 && stats.containsLatency.count() == 2 && stats.findRangeLatency.count() == 1,
+          "lookups timed");
+    check(stats.insertLatency.percentile(50) <= stats.insertLatency.percentile(99) &&
+          stats.insertLatency.percentile(99) <= stats.insertLatency.percentile(100), "percentiles ordered");
+
+    string dump = stats.toString();
+    for (const char *line : {"comparisons ", "rotations.left_right ", "nodes.freed ", "latency.insert count 5000"}) {
+        check(dump.find(line) != string::npos, string("text dump has ") + line);
+    }
+
+    tree.resetStats();
+    check(stats.comparisons == 0 && stats.allocations == 0 && stats.insertLatency.count() == 0, "resetStats");
+    checkTree(tree, reference, "after resetStats");
+}
+
+// bucket 0 holds 0 ns, bucket i holds [2^(i-1), 2^i) ns
+static void histogramBuckets() {
+    LatencyHistogram histogram;
+    check(histogram.percentile(50) == 0, "empty histogram");
+    for (uint64_t nanoseconds : {0, 1, 2, 3, 4, 1000}) {
+        histogram.record(nanoseconds);
+    }
+    check(histogram.count() == 6 && histogram.totalNanoseconds() == 1010, "samples and total");
+    check(histogram.buckets()[0] == 1 && histogram.buckets()[1] == 1 && histogram.buckets()[2] == 2 &&
+          histogram.buckets()[3] == 1 && histogram.buckets()[10] == 1, "bucket edges");
+    check(histogram.percentile(0) == 0 && histogram.percentile(50) == 3 && histogram.percentile(100) == 1023,
+          "percentile is the bucket's upper edge");
+    histogram.record(~uint64_t(0));
+    check(histogram.buckets()[LatencyHistogram::bucketCount - 1] == 1, "huge samples land in the last bucket");
+    histogram.reset();
+    check(histogram.count() == 0, "reset");
+}
+
+int main() {
+    rotationKinds();
+    operationCounters();
+    histogramBuckets();
+    cout << "stats: ok" << endl;
+    return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * AVLTreeTestSupport.h
+ */
+
+#ifndef AVLTREETESTSUPPORT_H
+#define AVLTREETESTSUPPORT_H
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+// Helpers for the ctest drivers. A driver checks every result against a
+// std::map oracle and exits nonzero on the first mismatch, naming it.
+
+inline void check(bool condition, const std::string &what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        std::exit(1);
+    }
+}
+
+// runs tree.verify() (parent links, heights, subtree sizes, balance, key
+// order) and compares size and every entry in order with expected
+template<typename Tree, typename Map>
+void checkTree(const Tree &tree, const Map &expected, const std::string &what) {
+    try {
+        tree.verify();
+    } catch (const std::exception &error) {
+        check(false, what + ": " + error.what());
+    }
+    check(tree.size() == expected.size(), what + ": size");
+    auto entry = expected.begin();
+    for (const auto &[key, value] : tree) {
+        check(entry != expected.end() && key == entry->first && value == entry->second, what + ": entries");
+        ++entry;
+    }
+}
+
+// true if fn throws an exception of type Error
+template<typename Error, typename Fn>
+bool throws(Fn &&fn) {
+    try {
+        fn();
+    } catch (const Error &) {
+        return true;
+    }
+    return false;
+}
+
+#endif //AVLTREETESTSUPPORT_H
@@ -0,0 +1,88 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * BinaryCodec.h
+ */
+
+#ifndef BINARYCODEC_H
+#define BINARYCODEC_H
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// How keys and values are written by AVLTree::save and read back by load.
+// Trivially copyable types are copied byte for byte and strings are a 64-bit
+// length followed by their bytes, all in the writer's byte order (files record
+// it and refuse to load on a machine that differs). Specialize BinaryCodec to
+// save other types.
+template<typename T>
+struct BinaryCodec;
+
+// fails the stream read with a message naming what was being read
+inline void readBytes(std::istream &in, void *data, std::size_t size, const char *what) {
+    if (size > 0 && !in.read(static_cast<char *>(data), std::streamsize(size))) {
+        throw std::runtime_error(std::string("unexpected end of data reading ") + what);
+    }
+}
+
+inline void writeBytes(std::ostream &out, const void *data, std::size_t size) {
+    out.write(static_cast<const char *>(data), std::streamsize(size));
+}
+
+template<typename T> requires std::is_trivially_copyable_v<T>
+struct BinaryCodec<T> {
+    static void write(std::ostream &out, const T &value) {
+        writeBytes(out, &value, sizeof(T));
+    }
+
+    static T read(std::istream &in) {
+        T value;
+        readBytes(in, &value, sizeof(T), "a fixed-size field");
+        return value;
+    }
+};
+
+template<>
+struct BinaryCodec<std::string> {
+    static void write(std::ostream &out, const std::string &value) {
+        BinaryCodec<std::uint64_t>::write(out, value.size());
+        writeBytes(out, value.data(), value.size());
+    }
+
+    static std::string read(std::istream &in) {
+        std::uint64_t size = BinaryCodec<std::uint64_t>::read(in);
+        std::string value;
+        // grow as bytes arrive, so a corrupt length fails on the short read
+        // instead of asking for an absurd allocation up front
+        constexpr std::uint64_t chunk = 1 << 16;
+        while (value.size() < size) {
+            std::size_t offset = value.size();
+            std::size_t step = std::size_t(std::min(chunk, size - offset));
+            value.resize(offset + step);
+            readBytes(in, value.data() + offset, step, "a string");
+        }
+        return value;
+    }
+};
+
+template<typename T>
+concept BinarySerializable = requires(std::ostream &out, std::istream &in, const T &value) {
+    BinaryCodec<T>::write(out, value);
+    { BinaryCodec<T>::read(in) } -> std::same_as<T>;
+};
+
+// leading fields shared by every file format here: a magic string naming the
+// format and a marker that reads back differently under the other byte order
+constexpr std::uint32_t binaryByteOrderMark = 0x01020304;
+
+#endif //BINARYCODEC_H
@@ -0,0 +1,13 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+#include "CompactAVLTree.h"
+#include <string>
+
+// member definitions live in CompactAVLTree.tpp, the default string -> size_t
+// tree is instantiated here once
+template class CompactAVLTree<std::string, size_t>;
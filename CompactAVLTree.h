@@ -0,0 +1,194 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * CompactAVLTree.h
+ */
+
+#ifndef COMPACTAVLTREE_H
+#define COMPACTAVLTREE_H
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "AVLTree.h"
+
+// AVLTree with a compact, cache-friendly layout, opt in where lookup latency
+// and memory per entry matter more than stable references. Nodes live in
+// contiguous arrays and link to each other with 32-bit indices. The links,
+// heights and (for std::string keys under std::less) the first 8 key bytes
+// sit together in one small record per node, away from the keys and values.
+// A search reads only these records until two keys share their first 8
+// bytes, so most steps never touch the string's heap buffer.
+//
+// Erasing moves the last entry into the freed slot to keep the arrays dense,
+// so pointers and references into the tree do not survive an erase.
+template<typename Key = std::string, typename Value = size_t, typename Compare = std::less<> >
+class CompactAVLTree {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+    using key_compare = Compare;
+
+    using KeyParam = std::conditional_t<std::is_trivially_copyable_v<Key> && sizeof(Key) <= 2 * sizeof(void *),
+        Key, const Key &>;
+
+    // one index value is reserved for "no node"
+    static constexpr size_t maxSize = std::numeric_limits<std::uint32_t>::max() - 1;
+
+    CompactAVLTree();
+
+    explicit CompactAVLTree(const Compare &comp);
+
+    // false if the key already exists; throws std::length_error past maxSize
+    bool insert(KeyParam key, const Value &value);
+
+    // true if key was inserted, false if an existing value was replaced
+    bool insert_or_assign(KeyParam key, const Value &value);
+
+    bool remove(KeyParam key);
+
+    bool contains(KeyParam key) const;
+
+    std::optional<Value> get(KeyParam key) const;
+
+    template<typename K> requires TransparentCompare<Compare>
+    bool contains(const K &key) const;
+
+    template<typename K> requires TransparentCompare<Compare>
+    std::optional<Value> get(const K &key) const;
+
+    // copies of every key in [lowKey, highKey], in order
+    std::vector<Key> findRange(const Key &lowKey, const Key &highKey) const;
+
+    // calls visit(key, value) for entries with keys in [lowKey, highKey] in
+    // ascending order, stopping after limit entries or when visit returns false
+    template<typename Visitor>
+    size_t forEachInRange(KeyParam lowKey, KeyParam highKey, Visitor &&visit,
+                          size_t limit = std::numeric_limits<size_t>::max()) const;
+
+    // all keys in sorted order
+    std::vector<Key> keys() const;
+
+    size_t size() const;
+
+    bool empty() const;
+
+    void clear();
+
+    // makes room for count entries so inserts up to that size do not reallocate
+    void reserve(size_t count);
+
+    // O(1), an empty tree reports 0 like a single leaf
+    size_t getHeight() const;
+
+    // bytes held by the node arrays, not counting memory keys or values own
+    size_t memoryUsage() const;
+
+    // O(n) structural check for tests and debugging: keys strictly increasing,
+    // parent links, stored heights and key prefixes, AVL balance and dense
+    // arrays. Throws std::logic_error naming the first broken invariant
+    void verify() const;
+
+private:
+    static constexpr std::uint32_t nil = std::numeric_limits<std::uint32_t>::max();
+
+    // the prefix orders keys exactly like the comparator only for plain
+    // lexicographic string order; any other key type or ordering compares in full
+    static constexpr bool usePrefix = std::is_same_v<Key, std::string> &&
+                                      (std::is_same_v<Compare, std::less<> > ||
+                                       std::is_same_v<Compare, std::less<std::string> >);
+
+    template<typename K>
+    static constexpr bool prefixable = usePrefix && std::is_convertible_v<const K &, std::string_view>;
+
+    struct NoPrefix {
+    };
+
+    // everything a search step reads, 24 bytes with the key prefix, 16 without
+    struct Link {
+        // first 8 key bytes, big-endian and zero padded, so comparing two
+        // prefixes as integers orders them like the strings whenever they differ
+        [[no_unique_address]] std::conditional_t<usePrefix, std::uint64_t, NoPrefix> prefix;
+        std::uint32_t left;
+        std::uint32_t right;
+        std::uint32_t parent;
+        // height of the subtree rooted here (leaf = 0), see AVLTree::AVLNode::height
+        std::uint8_t height;
+
+        std::uint32_t &child(bool rightSide) { return rightSide ? right : left; }
+    };
+
+    // slot i of each array belongs to the same entry
+    std::vector<Link> links;
+    std::vector<Key> keyStore;
+    std::vector<Value> valueStore;
+    std::uint32_t root;
+    [[no_unique_address]] Compare comp;
+
+    static std::uint64_t prefixOf(std::string_view key);
+
+    // negative, zero or positive as key orders before, with or after the key in slot node
+    template<typename K>
+    int compareAt(const K &key, std::uint64_t keyPrefix, std::uint32_t node) const;
+
+    template<typename K>
+    static std::uint64_t searchPrefix(const K &key);
+
+    // slot holding key or nil
+    template<typename K>
+    std::uint32_t findIndex(const K &key) const;
+
+    // slot holding key, or nil with parent/goRight describing where it belongs
+    std::uint32_t findInsertPosition(KeyParam key, std::uint32_t &parent, bool &goRight) const;
+
+    // appends an entry under parent and rebalances back up to the root
+    void attach(KeyParam key, const Value &value, std::uint32_t parent, bool goRight);
+
+    // unlinks the entry in slot node, rebalances and fills the slot from the back
+    void removeIndex(std::uint32_t node);
+
+    // moves the entry in slot from into slot to, repointing its neighbours
+    void relocate(std::uint32_t from, std::uint32_t to);
+
+    std::uint32_t lowerBoundIndex(KeyParam key) const;
+
+    std::uint32_t nextIndex(std::uint32_t node) const;
+
+    std::uint32_t minIndex(std::uint32_t node) const;
+
+    void retrace(std::uint32_t node);
+
+    std::uint32_t balanceNode(std::uint32_t node);
+
+    std::uint32_t rotate(std::uint32_t node, bool rightChildUp);
+
+    void setChild(std::uint32_t parent, bool rightSide, std::uint32_t child);
+
+    std::uint32_t &parentLink(std::uint32_t node);
+
+    int heightOf(std::uint32_t node) const;
+
+    void updateHeight(std::uint32_t node);
+
+    int getBalance(std::uint32_t node) const;
+
+    size_t verifyIndex(std::uint32_t node, std::uint32_t parent, std::uint32_t low, std::uint32_t high) const;
+};
+
+#include "CompactAVLTree.tpp"
+
+extern template class CompactAVLTree<std::string, size_t>;
+
+#endif //COMPACTAVLTREE_H
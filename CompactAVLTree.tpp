@@ -0,0 +1,506 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * CompactAVLTree.tpp
+ * Member definitions for CompactAVLTree, included at the bottom of CompactAVLTree.h.
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+
+template<typename Key, typename Value, typename Compare>
+CompactAVLTree<Key, Value, Compare>::CompactAVLTree() : CompactAVLTree(Compare()) {
+}
+
+template<typename Key, typename Value, typename Compare>
+CompactAVLTree<Key, Value, Compare>::CompactAVLTree(const Compare &comp) : root(nil), comp(comp) {
+}
+
+template<typename Key, typename Value, typename Compare>
+bool CompactAVLTree<Key, Value, Compare>::insert(KeyParam key, const Value &value) {
+    std::uint32_t parent;
+    bool goRight;
+    if (findInsertPosition(key, parent, goRight) != nil) {
+        return false; // key already exists
+    }
+    attach(key, value, parent, goRight);
+    return true;
+}
+
+template<typename Key, typename Value, typename Compare>
+bool CompactAVLTree<Key, Value, Compare>::insert_or_assign(KeyParam key, const Value &value) {
+    std::uint32_t parent;
+    bool goRight;
+    std::uint32_t existing = findInsertPosition(key, parent, goRight);
+    if (existing != nil) {
+        valueStore[existing] = value;
+        return false;
+    }
+    attach(key, value, parent, goRight);
+    return true;
+}
+
+template<typename Key, typename Value, typename Compare>
+bool CompactAVLTree<Key, Value, Compare>::remove(KeyParam key) {
+    std::uint32_t node = findIndex(key);
+    if (node == nil) {
+        return false; // key is not in the tree
+    }
+    removeIndex(node);
+    return true;
+}
+
+template<typename Key, typename Value, typename Compare>
+bool CompactAVLTree<Key, Value, Compare>::contains(KeyParam key) const {
+    return findIndex(key) != nil;
+}
+
+template<typename Key, typename Value, typename Compare>
+std::optional<Value> CompactAVLTree<Key, Value, Compare>::get(KeyParam key) const {
+    std::uint32_t node = findIndex(key);
+    if (node == nil) {
+        return std::nullopt;
+    }
+    return valueStore[node];
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K> requires TransparentCompare<Compare>
+bool CompactAVLTree<Key, Value, Compare>::contains(const K &key) const {
+    return findIndex(key) != nil;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K> requires TransparentCompare<Compare>
+std::optional<Value> CompactAVLTree<Key, Value, Compare>::get(const K &key) const {
+    std::uint32_t node = findIndex(key);
+    if (node == nil) {
+        return std::nullopt;
+    }
+    return valueStore[node];
+}
+
+template<typename Key, typename Value, typename Compare>
+std::vector<Key> CompactAVLTree<Key, Value, Compare>::findRange(const Key &lowKey, const Key &highKey) const {
+    std::vector<Key> keys;
+    forEachInRange(lowKey, highKey, [&keys](const Key &key, const Value &) {
+        keys.push_back(key);
+    });
+    return keys;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename Visitor>
+size_t CompactAVLTree<Key, Value, Compare>::forEachInRange(KeyParam lowKey, KeyParam highKey, Visitor &&visit,
+                                                           size_t limit) const {
+    if (comp(highKey, lowKey)) {
+        return 0;
+    }
+    size_t visited = 0;
+    for (std::uint32_t node = lowerBoundIndex(lowKey); node != nil && visited < limit; node = nextIndex(node)) {
+        if (compareAt(highKey, searchPrefix(highKey), node) < 0) {
+            break; // walked out of the range
+        }
+        visited++;
+        if constexpr (std::is_same_v<std::invoke_result_t<Visitor &, const Key &, const Value &>, bool>) {
+            if (!visit(keyStore[node], valueStore[node])) {
+                break; // visitor asked to stop
+            }
+        } else {
+            visit(keyStore[node], valueStore[node]);
+        }
+    }
+    return visited;
+}
+
+template<typename Key, typename Value, typename Compare>
+std::vector<Key> CompactAVLTree<Key, Value, Compare>::keys() const {
+    std::vector<Key> keys;
+    keys.reserve(keyStore.size());
+    for (std::uint32_t node = minIndex(root); node != nil; node = nextIndex(node)) {
+        keys.push_back(keyStore[node]);
+    }
+    return keys;
+}
+
+template<typename Key, typename Value, typename Compare>
+size_t CompactAVLTree<Key, Value, Compare>::size() const {
+    return links.size();
+}
+
+template<typename Key, typename Value, typename Compare>
+bool CompactAVLTree<Key, Value, Compare>::empty() const {
+    return links.empty();
+}
+
+template<typename Key, typename Value, typename Compare>
+void CompactAVLTree<Key, Value, Compare>::clear() {
+    // three array clears instead of one free per node
+    links.clear();
+    keyStore.clear();
+    valueStore.clear();
+    root = nil;
+}
+
+template<typename Key, typename Value, typename Compare>
+void CompactAVLTree<Key, Value, Compare>::reserve(size_t count) {
+    links.reserve(count);
+    keyStore.reserve(count);
+    valueStore.reserve(count);
+}
+
+template<typename Key, typename Value, typename Compare>
+size_t CompactAVLTree<Key, Value, Compare>::getHeight() const {
+    return root == nil ? 0 : links[root].height;
+}
+
+template<typename Key, typename Value, typename Compare>
+size_t CompactAVLTree<Key, Value, Compare>::memoryUsage() const {
+    return links.capacity() * sizeof(Link) + keyStore.capacity() * sizeof(Key) +
+           valueStore.capacity() * sizeof(Value);
+}
+
+template<typename Key, typename Value, typename Compare>
+void CompactAVLTree<Key, Value, Compare>::verify() const {
+    if (keyStore.size() != links.size() || valueStore.size() != links.size()) {
+        throw std::logic_error("CompactAVLTree::verify: arrays out of step");
+    }
+    // every slot is reachable from the root, so the arrays hold no holes
+    if (verifyIndex(root, nil, nil, nil) != links.size()) {
+        throw std::logic_error("CompactAVLTree::verify: size() does not match the node count");
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+size_t CompactAVLTree<Key, Value, Compare>::verifyIndex(std::uint32_t node, std::uint32_t parent,
+                                                        std::uint32_t low, std::uint32_t high) const {
+    if (node == nil) {
+        return 0;
+    }
+    if (node >= links.size()) {
+        throw std::logic_error("CompactAVLTree::verify: link past the end of the arrays");
+    }
+    const Link &link = links[node];
+    if (link.parent != parent) {
+        throw std::logic_error("CompactAVLTree::verify: broken parent link");
+    }
+    if ((low != nil && !comp(keyStore[low], keyStore[node])) ||
+        (high != nil && !comp(keyStore[node], keyStore[high]))) {
+        throw std::logic_error("CompactAVLTree::verify: keys out of order");
+    }
+    if constexpr (usePrefix) {
+        if (link.prefix != prefixOf(keyStore[node])) {
+            throw std::logic_error("CompactAVLTree::verify: stale key prefix");
+        }
+    }
+    size_t count = 1 + verifyIndex(link.left, node, low, node) + verifyIndex(link.right, node, node, high);
+    int leftHeight = heightOf(link.left);
+    int rightHeight = heightOf(link.right);
+    if (link.height != 1 + std::max(leftHeight, rightHeight)) {
+        throw std::logic_error("CompactAVLTree::verify: stale height");
+    }
+    if (std::abs(leftHeight - rightHeight) > 1) {
+        throw std::logic_error("CompactAVLTree::verify: subtree out of balance");
+    }
+    return count;
+}
+
+template<typename Key, typename Value, typename Compare>
+std::uint64_t CompactAVLTree<Key, Value, Compare>::prefixOf(std::string_view key) {
+    std::uint64_t prefix = 0;
+    size_t length = std::min<size_t>(key.size(), 8);
+    for (size_t i = 0; i < length; i++) {
+        prefix |= std::uint64_t(static_cast<unsigned char>(key[i])) << (56 - 8 * i);
+    }
+    return prefix;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K>
+std::uint64_t CompactAVLTree<Key, Value, Compare>::searchPrefix(const K &key) {
+    if constexpr (prefixable<K>) {
+        return prefixOf(std::string_view(key));
+    } else {
+        return 0;
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K>
+int CompactAVLTree<Key, Value, Compare>::compareAt(const K &key, std::uint64_t keyPrefix, std::uint32_t node) const {
+    if constexpr (prefixable<K>) {
+        std::uint64_t nodePrefix = links[node].prefix;
+        if (keyPrefix != nodePrefix) {
+            return keyPrefix < nodePrefix ? -1 : 1; // decided without touching the key
+        }
+        // equal prefixes mean the bytes both keys have among the first 8 match,
+        // the vector compare starts after them
+        std::string_view probe(key);
+        const std::string &nodeKey = keyStore[node];
+        size_t common;
+        return KeyCompare::compare(probe, nodeKey, std::min({size_t(8), probe.size(), nodeKey.size()}), common);
+    } else {
+        if (comp(key, keyStore[node])) {
+            return -1;
+        }
+        return comp(keyStore[node], key) ? 1 : 0;
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K>
+std::uint32_t CompactAVLTree<Key, Value, Compare>::findIndex(const K &key) const {
+    std::uint64_t keyPrefix = searchPrefix(key);
+    std::uint32_t current = root;
+    while (current != nil) {
+        int order = compareAt(key, keyPrefix, current);
+        if (order == 0) {
+            return current;
+        }
+        current = order < 0 ? links[current].left : links[current].right;
+    }
+    return nil; // key is not in the tree
+}
+
+template<typename Key, typename Value, typename Compare>
+std::uint32_t CompactAVLTree<Key, Value, Compare>::findInsertPosition(KeyParam key, std::uint32_t &parent,
+                                                                      bool &goRight) const {
+    std::uint64_t keyPrefix = searchPrefix(key);
+    parent = nil;
+    goRight = false;
+    std::uint32_t current = root;
+    while (current != nil) {
+        int order = compareAt(key, keyPrefix, current);
+        if (order == 0) {
+            return current;
+        }
+        parent = current;
+        goRight = order > 0;
+        current = goRight ? links[current].right : links[current].left;
+    }
+    return nil;
+}
+
+template<typename Key, typename Value, typename Compare>
+void CompactAVLTree<Key, Value, Compare>::attach(KeyParam key, const Value &value, std::uint32_t parent,
+                                                 bool goRight) {
+    if (links.size() >= maxSize) {
+        throw std::length_error("CompactAVLTree is full");
+    }
+    Link link{};
+    if constexpr (usePrefix) {
+        link.prefix = prefixOf(key);
+    }
+    link.left = nil;
+    link.right = nil;
+    link.parent = nil;
+    // grow all three arrays or none of them
+    keyStore.push_back(key);
+    try {
+        valueStore.push_back(value);
+        try {
+            links.push_back(link);
+        } catch (...) {
+            valueStore.pop_back();
+            throw;
+        }
+    } catch (...) {
+        keyStore.pop_back();
+        throw;
+    }
+    std::uint32_t node = static_cast<std::uint32_t>(links.size() - 1);
+    if (parent == nil) {
+        root = node; // tree was empty
+        return;
+    }
+    setChild(parent, goRight, node);
+    retrace(parent);
+}
+
+template<typename Key, typename Value, typename Compare>
+void CompactAVLTree<Key, Value, Compare>::removeIndex(std::uint32_t node) {
+    std::uint32_t retraceFrom;
+    Link &removed = links[node];
+    if (removed.left != nil && removed.right != nil) {
+        // two children: the in-order successor is relinked into node's place,
+        // as in AVLTree::removeNode
+        std::uint32_t successor = minIndex(removed.right);
+        if (links[successor].parent == node) {
+            retraceFrom = successor;
+        } else {
+            retraceFrom = links[successor].parent;
+            setChild(links[successor].parent, false, links[successor].right);
+            setChild(successor, true, removed.right);
+        }
+        setChild(successor, false, removed.left);
+        links[successor].height = removed.height;
+        parentLink(node) = successor;
+        links[successor].parent = removed.parent;
+    } else {
+        std::uint32_t child = removed.left != nil ? removed.left : removed.right;
+        parentLink(node) = child;
+        if (child != nil) {
+            links[child].parent = removed.parent;
+        }
+        retraceFrom = removed.parent;
+    }
+    retrace(retraceFrom);
+
+    // keep the arrays dense: the last entry moves into the freed slot
+    std::uint32_t last = static_cast<std::uint32_t>(links.size() - 1);
+    if (node != last) {
+        relocate(last, node);
+    }
+    links.pop_back();
+    keyStore.pop_back();
+    valueStore.pop_back();
+}
+
+template<typename Key, typename Value, typename Compare>
+void CompactAVLTree<Key, Value, Compare>::relocate(std::uint32_t from, std::uint32_t to) {
+    links[to] = links[from];
+    keyStore[to] = std::move(keyStore[from]);
+    valueStore[to] = std::move(valueStore[from]);
+    std::uint32_t parent = links[to].parent;
+    if (parent == nil) {
+        root = to;
+    } else {
+        links[parent].child(links[parent].right == from) = to;
+    }
+    if (links[to].left != nil) {
+        links[links[to].left].parent = to;
+    }
+    if (links[to].right != nil) {
+        links[links[to].right].parent = to;
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+std::uint32_t CompactAVLTree<Key, Value, Compare>::lowerBoundIndex(KeyParam key) const {
+    std::uint64_t keyPrefix = searchPrefix(key);
+    std::uint32_t best = nil;
+    std::uint32_t current = root;
+    while (current != nil) {
+        int order = compareAt(key, keyPrefix, current);
+        if (order <= 0) {
+            best = current; // candidate, look for a smaller one on the left
+            if (order == 0) {
+                break;
+            }
+            current = links[current].left;
+        } else {
+            current = links[current].right;
+        }
+    }
+    return best;
+}
+
+template<typename Key, typename Value, typename Compare>
+std::uint32_t CompactAVLTree<Key, Value, Compare>::nextIndex(std::uint32_t node) const {
+    if (links[node].right != nil) {
+        return minIndex(links[node].right);
+    }
+    // otherwise climb until we come up from a left child
+    std::uint32_t parent = links[node].parent;
+    while (parent != nil && links[parent].right == node) {
+        node = parent;
+        parent = links[node].parent;
+    }
+    return parent;
+}
+
+template<typename Key, typename Value, typename Compare>
+std::uint32_t CompactAVLTree<Key, Value, Compare>::minIndex(std::uint32_t node) const {
+    if (node == nil) {
+        return nil;
+    }
+    while (links[node].left != nil) {
+        node = links[node].left;
+    }
+    return node;
+}
+
+template<typename Key, typename Value, typename Compare>
+void CompactAVLTree<Key, Value, Compare>::retrace(std::uint32_t node) {
+    while (node != nil) {
+        std::uint8_t oldHeight = links[node].height;
+        std::uint32_t subtreeRoot = balanceNode(node);
+        if (links[subtreeRoot].height == oldHeight) {
+            // this subtree is as tall as before, nothing above it can have changed
+            return;
+        }
+        node = links[subtreeRoot].parent;
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+std::uint32_t CompactAVLTree<Key, Value, Compare>::balanceNode(std::uint32_t node) {
+    updateHeight(node);
+    int balance = getBalance(node);
+    if (balance == -2) {
+        if (getBalance(links[node].right) == 1) {
+            rotate(links[node].right, false); // double rotation case
+        }
+        return rotate(node, true);
+    }
+    if (balance == 2) {
+        if (getBalance(links[node].left) == -1) {
+            rotate(links[node].left, true);
+        }
+        return rotate(node, false);
+    }
+    return node;
+}
+
+template<typename Key, typename Value, typename Compare>
+std::uint32_t CompactAVLTree<Key, Value, Compare>::rotate(std::uint32_t node, bool rightChildUp) {
+    // same shape change as AVLTree::rotate, on indices
+    std::uint32_t pivot = links[node].child(rightChildUp);
+    std::uint32_t inner = links[pivot].child(!rightChildUp);
+    parentLink(node) = pivot;
+    links[pivot].parent = links[node].parent;
+    setChild(pivot, !rightChildUp, node);
+    setChild(node, rightChildUp, inner);
+    updateHeight(node);
+    updateHeight(pivot);
+    return pivot;
+}
+
+template<typename Key, typename Value, typename Compare>
+void CompactAVLTree<Key, Value, Compare>::setChild(std::uint32_t parent, bool rightSide, std::uint32_t child) {
+    links[parent].child(rightSide) = child;
+    if (child != nil) {
+        links[child].parent = parent;
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+std::uint32_t &CompactAVLTree<Key, Value, Compare>::parentLink(std::uint32_t node) {
+    std::uint32_t parent = links[node].parent;
+    if (parent == nil) {
+        return root;
+    }
+    return links[parent].child(links[parent].right == node);
+}
+
+template<typename Key, typename Value, typename Compare>
+int CompactAVLTree<Key, Value, Compare>::heightOf(std::uint32_t node) const {
+    return node == nil ? -1 : links[node].height;
+}
+
+template<typename Key, typename Value, typename Compare>
+void CompactAVLTree<Key, Value, Compare>::updateHeight(std::uint32_t node) {
+    links[node].height = static_cast<std::uint8_t>(1 + std::max(heightOf(links[node].left),
+                                                                heightOf(links[node].right)));
+}
+
+template<typename Key, typename Value, typename Compare>
+int CompactAVLTree<Key, Value, Compare>::getBalance(std::uint32_t node) const {
+    return heightOf(links[node].left) - heightOf(links[node].right);
+}
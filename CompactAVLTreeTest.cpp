@@ -0,0 +1,135 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for CompactAVLTree, checked against std::map. String keys share
+long prefixes so searches fall back from the inline 8 byte prefix to full
+comparisons, and erases keep moving entries between slots.
+ */
+#include "CompactAVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+// structure plus every entry, in order, through keys() and get()
+template<typename Tree, typename Map>
+static void checkCompact(const Tree &tree, const Map &reference, const string &what) {
+    try {
+        tree.verify();
+    } catch (const exception &error) {
+        check(false, what + ": " + error.what());
+    }
+    check(tree.size() == reference.size() && tree.empty() == reference.empty(), what + ": size");
+    auto keys = tree.keys();
+    auto entry = reference.begin();
+    for (const auto &key : keys) {
+        check(entry != reference.end() && key == entry->first && tree.get(key) == entry->second, what + ": entries");
+        ++entry;
+    }
+    check(entry == reference.end(), what + ": key count");
+}
+
+// keys that tie on the first 8 bytes, differ only past them, are shorter than
+// the prefix, or are empty
+static string randomKey(mt19937 &random) {
+    static const vector<string> stems = {"", "a", "abc", "abcdefg", "abcdefgh", "abcdefghij", "user:0000",
+                                         "user:00001234"};
+    string key = stems[random() % stems.size()];
+    size_t tail = random() % 3;
+    for (size_t i = 0; i < tail; i++) {
+        key += char('a' + random() % 4);
+    }
+    if (random() % 8 == 0) {
+        key += '\0'; // a zero byte sorts after the shorter key, not equal to it
+    }
+    return key;
+}
+
+static void stringKeys() {
+    mt19937 random(16);
+    CompactAVLTree<> tree;
+    map<string, size_t> reference;
+    for (size_t i = 0; i < 20000; i++) {
+        string key = randomKey(random);
+        switch (random() % 4) {
+            case 0:
+                check(tree.remove(key) == (reference.erase(key) == 1), "remove");
+                break;
+            case 1: {
+                bool inserted = reference.find(key) == reference.end();
+                reference[key] = i;
+                check(tree.insert_or_assign(key, i) == inserted, "insert_or_assign");
+                break;
+            }
+            default:
+                check(tree.insert(key, i) == reference.emplace(key, i).second, "insert");
+                break;
+        }
+        string probe = randomKey(random);
+        auto expected = reference.find(probe);
+        check(tree.contains(probe) == (expected != reference.end()), "contains");
+        check(tree.get(string_view(probe)) == (expected == reference.end() ? nullopt : optional(expected->second)),
+              "transparent get");
+        if (i % 1000 == 0) {
+            checkCompact(tree, reference, "strings");
+        }
+    }
+    checkCompact(tree, reference, "strings");
+
+    // ranges agree with the map, including bounds that tie on the prefix
+    vector<string> found = tree.findRange("abcdefgh", "abcdefghz");
+    vector<string> expected;
+    for (auto it = reference.lower_bound("abcdefgh"); it != reference.upper_bound("abcdefghz"); ++it) {
+        expected.push_back(it->first);
+    }
+    check(found == expected, "findRange");
+    size_t visited = tree.forEachInRange("a", "b", [](const string &, const size_t &) {}, 5);
+    check(visited == min<size_t>(5, distance(reference.lower_bound("a"), reference.upper_bound("b"))),
+          "forEachInRange limit");
+
+    // draining the tree leaves it empty and usable
+    for (const auto &[key, value] : reference) {
+        check(tree.remove(key), "drain");
+    }
+    reference.clear();
+    checkCompact(tree, reference, "drained");
+    tree.insert("again", 1);
+    reference.emplace("again", 1);
+    checkCompact(tree, reference, "reused");
+}
+
+// other key types compare in full, with no prefix
+static void integerKeys() {
+    mt19937 random(17);
+    CompactAVLTree<int, int> tree;
+    map<int, int> reference;
+    tree.reserve(5000);
+    size_t reserved = tree.memoryUsage();
+    for (int i = 0; i < 5000; i++) {
+        int key = int(random() % 8000);
+        check(tree.insert(key, i) == reference.emplace(key, i).second, "int insert");
+    }
+    check(tree.memoryUsage() == reserved, "reserve holds every insert");
+    checkCompact(tree, reference, "ints");
+    for (int key = 0; key < 8000; key += 3) {
+        check(tree.remove(key) == (reference.erase(key) == 1), "int remove");
+    }
+    checkCompact(tree, reference, "ints after removes");
+    tree.clear();
+    check(tree.empty() && tree.getHeight() == 0, "clear");
+}
+
+int main() {
+    stringKeys();
+    integerKeys();
+    cout << "compact: ok" << endl;
+    return 0;
+}
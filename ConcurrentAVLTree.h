@@ -0,0 +1,307 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * ConcurrentAVLTree.h
+ */
+
+#ifndef CONCURRENTAVLTREE_H
+#define CONCURRENTAVLTREE_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "AVLTree.h"
+#include "EpochDomain.h"
+
+// AVL map that many threads can read while others write, without readers ever
+// taking a lock. Published nodes are never modified: a writer copies the nodes
+// on the path it changes (O(log n) of them), rebalances the copies, then swaps
+// in the new root with one atomic store. Readers load the root once and see a
+// consistent tree for the whole traversal. Writers are serialized by a mutex;
+// the versions they replace are freed through EpochDomain once no reader can
+// still be standing on them.
+//
+// Every write leaves the previous version intact, so snapshot() hands out a
+// read-only view of the current version in O(1). Versions share every node
+// the writes in between did not copy; nodes are reference counted and a node
+// goes away with the last version that contains it.
+//
+// Keys and values must be copyable, since every write copies its path.
+template<typename Key = std::string, typename Value = size_t, typename Compare = std::less<> >
+class ConcurrentAVLTree {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+    using size_type = size_t;
+    using key_compare = Compare;
+
+    // small trivially copyable keys are passed and compared by value, as in AVLTree
+    using KeyParam = std::conditional_t<std::is_trivially_copyable_v<Key> && sizeof(Key) <= 2 * sizeof(void *),
+        Key, const Key &>;
+
+    class Snapshot;
+
+    ConcurrentAVLTree();
+
+    explicit ConcurrentAVLTree(const Compare &comp);
+
+    ConcurrentAVLTree(const ConcurrentAVLTree &) = delete;
+
+    ConcurrentAVLTree &operator=(const ConcurrentAVLTree &) = delete;
+
+    // no other thread may be using the tree any more
+    ~ConcurrentAVLTree();
+
+    // writers, serialized against each other; each publishes a new root
+    bool insert(KeyParam key, const Value &value);
+
+    // true if key was inserted, false if an existing value was replaced
+    bool insert_or_assign(KeyParam key, const Value &value);
+
+    bool remove(KeyParam key);
+
+    void clear();
+
+    // readers, lock-free and safe to call concurrently with the writers above;
+    // each call sees the tree as of one published write
+    bool contains(KeyParam key) const;
+
+    std::optional<Value> get(KeyParam key) const;
+
+    template<typename K> requires TransparentCompare<Compare>
+    bool contains(const K &key) const;
+
+    template<typename K> requires TransparentCompare<Compare>
+    std::optional<Value> get(const K &key) const;
+
+    // copies of every key in [lowKey, highKey], in order
+    std::vector<Key> findRange(const Key &lowKey, const Key &highKey) const;
+
+    // calls visit(key, value) for entries with keys in [lowKey, highKey] in
+    // ascending order, stopping after limit entries or when visit returns false.
+    // The references are only valid during the call
+    template<typename Visitor>
+    size_t forEachInRange(KeyParam lowKey, KeyParam highKey, Visitor &&visit,
+                          size_t limit = std::numeric_limits<size_t>::max()) const;
+
+    std::vector<Key> keys() const;
+
+    size_t size() const;
+
+    bool empty() const;
+
+    // O(1) read-only view of the tree as of the latest completed write; it stays
+    // valid and unchanged however the tree changes afterwards, and may outlive
+    // the tree. Waits for a write in progress, never for readers
+    Snapshot snapshot();
+
+    // frees versions no reader can reach any more; writers do this on their own
+    // every reclaimThreshold replaced versions
+    void reclaim();
+
+    static constexpr size_t reclaimThreshold = 256;
+
+private:
+    struct Node {
+        value_type entry;
+        std::uint8_t height;
+        Node *left;
+        Node *right;
+        // the write that created this node; only nodes of the write in progress
+        // are unpublished and may still be changed
+        std::uint64_t version;
+        // parents pointing here plus versions rooted here (the live tree's root,
+        // snapshots and retired roots waiting for their epoch)
+        std::atomic<std::uint32_t> refs;
+
+        template<typename K, typename V>
+        Node(K &&key, V &&value, std::uint64_t version)
+            : entry(std::forward<K>(key), std::forward<V>(value)), height(0), left(nullptr), right(nullptr),
+              version(version), refs(1) {
+        }
+
+        const Key &key() const { return entry.first; }
+
+        Node *&child(bool rightSide) { return rightSide ? right : left; }
+    };
+
+    // an AVL tree over 2^64 keys is under 93 tall, see AVLTree::AVLNode::height
+    static constexpr int maxDepth = 96;
+
+    std::atomic<Node *> root;
+    std::atomic<size_t> treeSize;
+    [[no_unique_address]] Compare comp;
+
+    // everything below belongs to the writer holding writeLock
+    std::mutex writeLock;
+    std::uint64_t writeVersion;
+    std::uint64_t publishedVersion; // the write that produced the current root
+    std::vector<std::pair<std::uint64_t, Node *> > retired; // (epoch tag, replaced root), oldest first
+
+    // lookups shared by the tree and its snapshots
+    template<typename K>
+    static const Node *findIn(const Node *root, const K &key, const Compare &comp);
+
+    template<typename Visitor>
+    static size_t forEachIn(const Node *root, KeyParam lowKey, KeyParam highKey, Visitor &visit, size_t limit,
+                            const Compare &comp);
+
+    static std::vector<Key> keysOf(const Node *root, size_t count);
+
+    // a copy of node's entry and children made by the current write
+    Node *copyNode(const Node *node);
+
+    // node itself when the current write created it, otherwise a private copy
+    // that replaces it in the new version
+    Node *writable(Node *node);
+
+    // hangs child under each copied ancestor in path from the bottom up,
+    // rebalancing on the way, and returns the new root. When successor is set,
+    // the node at removedAt is replaced by a copy of successor's entry
+    Node *rebuildPath(Node **path, const bool *side, int depth, Node *child,
+                      int removedAt = -1, const Node *successor = nullptr);
+
+    // node must be writable; updates its height and rotates if needed
+    Node *balance(Node *node);
+
+    Node *rotate(Node *node, bool rightChildUp);
+
+    static int heightOf(const Node *node);
+
+    static void updateHeight(Node *node);
+
+    // makes newRoot visible to readers and retires the version it replaces
+    void publish(Node *newRoot);
+
+    // gives every old node the new version shares one more reference
+    void adopt(Node *node);
+
+    void reclaimLocked();
+
+    // frees the nodes the failed write created, everything it shared stays
+    void discardFresh(Node *node);
+
+    // drops one reference to node, freeing it and releasing its children when
+    // it was the last
+    static void release(Node *node);
+
+public:
+    // Immutable version of a ConcurrentAVLTree. Copies share the version; the
+    // nodes stay alive until the last copy is gone.
+    class Snapshot {
+    public:
+        class const_iterator;
+        using iterator = const_iterator;
+
+        Snapshot() = default;
+
+        Snapshot(const Snapshot &other);
+
+        Snapshot(Snapshot &&other) noexcept;
+
+        Snapshot &operator=(Snapshot other) noexcept;
+
+        ~Snapshot();
+
+        // the write this snapshot reflects; a later snapshot of the same tree
+        // has an equal version exactly when no write happened in between
+        std::uint64_t version() const { return snapshotVersion; }
+
+        bool contains(KeyParam key) const;
+
+        std::optional<Value> get(KeyParam key) const;
+
+        template<typename K> requires TransparentCompare<Compare>
+        bool contains(const K &key) const;
+
+        template<typename K> requires TransparentCompare<Compare>
+        std::optional<Value> get(const K &key) const;
+
+        std::vector<Key> findRange(const Key &lowKey, const Key &highKey) const;
+
+        template<typename Visitor>
+        size_t forEachInRange(KeyParam lowKey, KeyParam highKey, Visitor &&visit,
+                              size_t limit = std::numeric_limits<size_t>::max()) const;
+
+        std::vector<Key> keys() const;
+
+        size_t size() const { return count; }
+
+        bool empty() const { return count == 0; }
+
+        // in-order traversal; there are no parent links, so an iterator carries
+        // the path of ancestors still to be visited
+        const_iterator begin() const;
+
+        const_iterator end() const;
+
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using iterator_concept = std::forward_iterator_tag;
+            using value_type = ConcurrentAVLTree::value_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = const value_type &;
+            using pointer = const value_type *;
+
+            const_iterator() = default;
+
+            reference operator*() const { return pending.back()->entry; }
+
+            pointer operator->() const { return &pending.back()->entry; }
+
+            const_iterator &operator++();
+
+            const_iterator operator++(int) {
+                const_iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            friend bool operator==(const const_iterator &a, const const_iterator &b) {
+                return a.current() == b.current();
+            }
+
+        private:
+            friend class Snapshot;
+
+            std::vector<const Node *> pending; // back() is the current entry, empty at end()
+
+            const Node *current() const { return pending.empty() ? nullptr : pending.back(); }
+
+            void pushLeftSpine(const Node *node);
+        };
+
+    private:
+        friend class ConcurrentAVLTree;
+
+        const Node *root = nullptr; // holds one reference
+        size_t count = 0;
+        std::uint64_t snapshotVersion = 0;
+        [[no_unique_address]] Compare comp;
+
+        Snapshot(const Node *root, size_t count, std::uint64_t version, const Compare &comp)
+            : root(root), count(count), snapshotVersion(version), comp(comp) {
+        }
+    };
+};
+
+#include "ConcurrentAVLTree.tpp"
+
+extern template class ConcurrentAVLTree<std::string, size_t>;
+
+#endif //CONCURRENTAVLTREE_H
@@ -0,0 +1,551 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * ConcurrentAVLTree.tpp
+ * Member definitions for ConcurrentAVLTree, included at the bottom of ConcurrentAVLTree.h.
+ */
+#include <algorithm>
+
+
+template<typename Key, typename Value, typename Compare>
+ConcurrentAVLTree<Key, Value, Compare>::ConcurrentAVLTree() : ConcurrentAVLTree(Compare()) {
+}
+
+template<typename Key, typename Value, typename Compare>
+ConcurrentAVLTree<Key, Value, Compare>::ConcurrentAVLTree(const Compare &comp)
+    : root(nullptr), treeSize(0), comp(comp), writeVersion(0), publishedVersion(0) {
+}
+
+template<typename Key, typename Value, typename Compare>
+ConcurrentAVLTree<Key, Value, Compare>::~ConcurrentAVLTree() {
+    // nodes still shared with snapshots survive until those are gone too
+    release(root.load());
+    for (auto &[tag, oldRoot] : retired) {
+        release(oldRoot);
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+bool ConcurrentAVLTree<Key, Value, Compare>::insert(KeyParam key, const Value &value) {
+    std::lock_guard<std::mutex> lock(writeLock);
+    ++writeVersion;
+    Node *path[maxDepth];
+    bool side[maxDepth];
+    int depth = 0;
+    KeyDescent<Key, Compare, Key> order(comp, key);
+    for (Node *current = root.load(); current; current = current->child(side[depth++])) {
+        int direction = order(current->key());
+        if (direction == 0) {
+            return false; // key already exists
+        }
+        side[depth] = direction > 0;
+        path[depth] = current;
+    }
+    Node *newRoot = rebuildPath(path, side, depth, new Node(key, value, writeVersion));
+    publish(newRoot);
+    treeSize.fetch_add(1);
+    return true;
+}
+
+template<typename Key, typename Value, typename Compare>
+bool ConcurrentAVLTree<Key, Value, Compare>::insert_or_assign(KeyParam key, const Value &value) {
+    std::lock_guard<std::mutex> lock(writeLock);
+    ++writeVersion;
+    Node *path[maxDepth];
+    bool side[maxDepth];
+    int depth = 0;
+    KeyDescent<Key, Compare, Key> order(comp, key);
+    for (Node *current = root.load(); current; current = current->child(side[depth++])) {
+        int direction = order(current->key());
+        if (direction == 0) {
+            // readers may be looking at the old value, so it gets a new node too
+            Node *replacement = new Node(current->key(), value, writeVersion);
+            replacement->left = current->left;
+            replacement->right = current->right;
+            replacement->height = current->height;
+            publish(rebuildPath(path, side, depth, replacement));
+            return false;
+        }
+        side[depth] = direction > 0;
+        path[depth] = current;
+    }
+    publish(rebuildPath(path, side, depth, new Node(key, value, writeVersion)));
+    treeSize.fetch_add(1);
+    return true;
+}
+
+template<typename Key, typename Value, typename Compare>
+bool ConcurrentAVLTree<Key, Value, Compare>::remove(KeyParam key) {
+    std::lock_guard<std::mutex> lock(writeLock);
+    ++writeVersion;
+    Node *path[maxDepth];
+    bool side[maxDepth];
+    int depth = 0;
+    Node *target = root.load();
+    KeyDescent<Key, Compare, Key> order(comp, key);
+    while (target) {
+        int direction = order(target->key());
+        if (direction == 0) {
+            break;
+        }
+        side[depth] = direction > 0;
+        path[depth] = target;
+        target = target->child(side[depth++]);
+    }
+    if (!target) {
+        return false; // key is not in the tree
+    }
+    Node *newRoot;
+    if (!target->left || !target->right) {
+        // zero or one child, the child moves up into target's place
+        newRoot = rebuildPath(path, side, depth, target->left ? target->left : target->right);
+    } else {
+        // two children: a copy of the in-order successor takes target's place and
+        // the successor's right subtree takes the successor's place
+        int removedAt = depth;
+        path[depth] = target;
+        side[depth++] = true;
+        Node *successor = target->right;
+        while (successor->left) {
+            path[depth] = successor;
+            side[depth++] = false;
+            successor = successor->left;
+        }
+        newRoot = rebuildPath(path, side, depth, successor->right, removedAt, successor);
+    }
+    publish(newRoot);
+    treeSize.fetch_sub(1);
+    return true;
+}
+
+template<typename Key, typename Value, typename Compare>
+void ConcurrentAVLTree<Key, Value, Compare>::clear() {
+    std::lock_guard<std::mutex> lock(writeLock);
+    ++writeVersion;
+    publish(nullptr); // the old version is retired as a whole
+    treeSize.store(0);
+}
+
+template<typename Key, typename Value, typename Compare>
+bool ConcurrentAVLTree<Key, Value, Compare>::contains(KeyParam key) const {
+    EpochDomain::Guard guard;
+    return findIn(root.load(), key, comp) != nullptr;
+}
+
+template<typename Key, typename Value, typename Compare>
+std::optional<Value> ConcurrentAVLTree<Key, Value, Compare>::get(KeyParam key) const {
+    EpochDomain::Guard guard;
+    if (const Node *node = findIn(root.load(), key, comp)) {
+        return node->entry.second; // copied out while the node is still protected
+    }
+    return std::nullopt;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K> requires TransparentCompare<Compare>
+bool ConcurrentAVLTree<Key, Value, Compare>::contains(const K &key) const {
+    EpochDomain::Guard guard;
+    return findIn(root.load(), key, comp) != nullptr;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K> requires TransparentCompare<Compare>
+std::optional<Value> ConcurrentAVLTree<Key, Value, Compare>::get(const K &key) const {
+    EpochDomain::Guard guard;
+    if (const Node *node = findIn(root.load(), key, comp)) {
+        return node->entry.second;
+    }
+    return std::nullopt;
+}
+
+template<typename Key, typename Value, typename Compare>
+std::vector<Key> ConcurrentAVLTree<Key, Value, Compare>::findRange(const Key &lowKey, const Key &highKey) const {
+    std::vector<Key> keys;
+    forEachInRange(lowKey, highKey, [&keys](const Key &key, const Value &) {
+        keys.push_back(key);
+    });
+    return keys;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename Visitor>
+size_t ConcurrentAVLTree<Key, Value, Compare>::forEachInRange(KeyParam lowKey, KeyParam highKey, Visitor &&visit,
+                                                              size_t limit) const {
+    EpochDomain::Guard guard;
+    return forEachIn(root.load(), lowKey, highKey, visit, limit, comp);
+}
+
+template<typename Key, typename Value, typename Compare>
+std::vector<Key> ConcurrentAVLTree<Key, Value, Compare>::keys() const {
+    EpochDomain::Guard guard;
+    return keysOf(root.load(), treeSize.load());
+}
+
+template<typename Key, typename Value, typename Compare>
+size_t ConcurrentAVLTree<Key, Value, Compare>::size() const {
+    return treeSize.load();
+}
+
+template<typename Key, typename Value, typename Compare>
+bool ConcurrentAVLTree<Key, Value, Compare>::empty() const {
+    return size() == 0;
+}
+
+template<typename Key, typename Value, typename Compare>
+auto ConcurrentAVLTree<Key, Value, Compare>::snapshot() -> Snapshot {
+    // under the write lock the root cannot be retired underneath us, and its
+    // version and size belong to it
+    std::lock_guard<std::mutex> lock(writeLock);
+    Node *current = root.load();
+    if (current) {
+        current->refs.fetch_add(1);
+    }
+    return Snapshot(current, treeSize.load(), publishedVersion, comp);
+}
+
+template<typename Key, typename Value, typename Compare>
+void ConcurrentAVLTree<Key, Value, Compare>::reclaim() {
+    std::lock_guard<std::mutex> lock(writeLock);
+    reclaimLocked();
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K>
+auto ConcurrentAVLTree<Key, Value, Compare>::findIn(const Node *root, const K &key, const Compare &comp)
+    -> const Node * {
+    const Node *current = root;
+    KeyDescent<Key, Compare, K> order(comp, key);
+    while (current) {
+        int side = order(current->key());
+        if (side == 0) {
+            return current;
+        }
+        current = side < 0 ? current->left : current->right;
+    }
+    return nullptr;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename Visitor>
+size_t ConcurrentAVLTree<Key, Value, Compare>::forEachIn(const Node *root, KeyParam lowKey, KeyParam highKey,
+                                                         Visitor &visit, size_t limit, const Compare &comp) {
+    if (comp(highKey, lowKey)) {
+        return 0;
+    }
+    // there are no parent links, so the walk keeps the path of pending ancestors
+    const Node *pending[maxDepth];
+    int depth = 0;
+    const Node *current = root;
+    size_t visited = 0;
+    while (visited < limit) {
+        while (current) {
+            if (comp(current->key(), lowKey)) {
+                current = current->right; // the whole left side is below the range
+            } else {
+                pending[depth++] = current;
+                current = current->left;
+            }
+        }
+        if (depth == 0) {
+            break;
+        }
+        current = pending[--depth];
+        if (comp(highKey, current->key())) {
+            break; // walked out of the range
+        }
+        visited++;
+        if constexpr (std::is_same_v<std::invoke_result_t<Visitor &, const Key &, const Value &>, bool>) {
+            if (!visit(current->key(), current->entry.second)) {
+                break; // visitor asked to stop
+            }
+        } else {
+            visit(current->key(), current->entry.second);
+        }
+        current = current->right;
+    }
+    return visited;
+}
+
+template<typename Key, typename Value, typename Compare>
+std::vector<Key> ConcurrentAVLTree<Key, Value, Compare>::keysOf(const Node *root, size_t count) {
+    std::vector<Key> keys;
+    keys.reserve(count);
+    const Node *pending[maxDepth];
+    int depth = 0;
+    for (const Node *current = root; current || depth > 0; current = current->right) {
+        for (; current; current = current->left) {
+            pending[depth++] = current;
+        }
+        current = pending[--depth];
+        keys.push_back(current->key());
+    }
+    return keys;
+}
+
+template<typename Key, typename Value, typename Compare>
+auto ConcurrentAVLTree<Key, Value, Compare>::copyNode(const Node *node) -> Node * {
+    Node *copy = new Node(node->entry.first, node->entry.second, writeVersion);
+    copy->left = node->left;
+    copy->right = node->right;
+    copy->height = node->height;
+    return copy;
+}
+
+template<typename Key, typename Value, typename Compare>
+auto ConcurrentAVLTree<Key, Value, Compare>::writable(Node *node) -> Node * {
+    if (node->version == writeVersion) {
+        return node;
+    }
+    // the original stays in the old version, which is released as a whole
+    return copyNode(node);
+}
+
+template<typename Key, typename Value, typename Compare>
+auto ConcurrentAVLTree<Key, Value, Compare>::rebuildPath(Node **path, const bool *side, int depth, Node *child,
+                                                         int removedAt, const Node *successor) -> Node * {
+    try {
+        for (int i = depth - 1; i >= 0; i--) {
+            Node *node;
+            if (i == removedAt) {
+                node = new Node(successor->entry.first, successor->entry.second, writeVersion);
+                node->left = path[i]->left;
+                node->right = path[i]->right;
+            } else {
+                node = writable(path[i]);
+            }
+            node->child(side[i]) = child;
+            child = node; // from here on the new subtree is reachable for cleanup
+            child = balance(node);
+        }
+    } catch (...) {
+        // nothing was published, the old tree is still the live one
+        discardFresh(child);
+        throw;
+    }
+    return child;
+}
+
+template<typename Key, typename Value, typename Compare>
+auto ConcurrentAVLTree<Key, Value, Compare>::balance(Node *node) -> Node * {
+    updateHeight(node);
+    int balanceFactor = heightOf(node->left) - heightOf(node->right);
+    if (balanceFactor > 1 || balanceFactor < -1) {
+        bool leftHeavy = balanceFactor > 1;
+        Node *&tall = node->child(!leftHeavy);
+        tall = writable(tall);
+        // zig-zag case, turn the taller child's inner subtree outward first
+        if (heightOf(tall->child(leftHeavy)) > heightOf(tall->child(!leftHeavy))) {
+            tall = rotate(tall, leftHeavy);
+        }
+        return rotate(node, !leftHeavy);
+    }
+    return node;
+}
+
+template<typename Key, typename Value, typename Compare>
+auto ConcurrentAVLTree<Key, Value, Compare>::rotate(Node *node, bool rightChildUp) -> Node * {
+    Node *&upLink = node->child(rightChildUp);
+    upLink = writable(upLink); // linked right away so a failed write can still find it
+    Node *up = upLink;
+    upLink = up->child(!rightChildUp);
+    up->child(!rightChildUp) = node;
+    updateHeight(node);
+    updateHeight(up);
+    return up;
+}
+
+template<typename Key, typename Value, typename Compare>
+int ConcurrentAVLTree<Key, Value, Compare>::heightOf(const Node *node) {
+    return node ? node->height : -1;
+}
+
+template<typename Key, typename Value, typename Compare>
+void ConcurrentAVLTree<Key, Value, Compare>::updateHeight(Node *node) {
+    node->height = static_cast<std::uint8_t>(1 + std::max(heightOf(node->left), heightOf(node->right)));
+}
+
+template<typename Key, typename Value, typename Compare>
+void ConcurrentAVLTree<Key, Value, Compare>::publish(Node *newRoot) {
+    if (newRoot && newRoot->version != writeVersion) {
+        // an old node moved up to the top (the root was removed and had at
+        // most one child); the reference it has belongs to its old parent
+        newRoot->refs.fetch_add(1);
+    }
+    adopt(newRoot);
+    Node *oldRoot = root.exchange(newRoot);
+    publishedVersion = writeVersion;
+    if (oldRoot) {
+        // tagged after the store: a reader that announced a later epoch loaded
+        // the new root and cannot reach the old version through the live tree
+        retired.emplace_back(EpochDomain::instance().currentEpoch(), oldRoot);
+    }
+    if (retired.size() >= reclaimThreshold) {
+        reclaimLocked();
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+void ConcurrentAVLTree<Key, Value, Compare>::adopt(Node *node) {
+    // the new nodes are the top of the tree down to where it meets the old one;
+    // each starts with the one reference its parent (or the root) holds
+    if (!node || node->version != writeVersion) {
+        return;
+    }
+    for (Node *child : {node->left, node->right}) {
+        if (child && child->version != writeVersion) {
+            child->refs.fetch_add(1);
+        } else {
+            adopt(child);
+        }
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+void ConcurrentAVLTree<Key, Value, Compare>::reclaimLocked() {
+    EpochDomain &domain = EpochDomain::instance();
+    domain.advance();
+    std::uint64_t safe = domain.safeEpoch();
+    // tags only grow, so the versions to drop are a prefix of retired; a version
+    // a snapshot still holds keeps its nodes after this
+    auto firstKept = std::find_if(retired.begin(), retired.end(), [safe](const auto &entry) {
+        return entry.first >= safe;
+    });
+    for (auto it = retired.begin(); it != firstKept; ++it) {
+        release(it->second);
+    }
+    retired.erase(retired.begin(), firstKept);
+}
+
+template<typename Key, typename Value, typename Compare>
+void ConcurrentAVLTree<Key, Value, Compare>::discardFresh(Node *node) {
+    if (!node || node->version != writeVersion) {
+        return; // published nodes belong to the live tree
+    }
+    discardFresh(node->left);
+    discardFresh(node->right);
+    delete node;
+}
+
+template<typename Key, typename Value, typename Compare>
+void ConcurrentAVLTree<Key, Value, Compare>::release(Node *node) {
+    // recursion is bounded by the height; the right side is walked in a loop
+    while (node && node->refs.fetch_sub(1) == 1) {
+        release(node->left);
+        Node *right = node->right;
+        delete node;
+        node = right;
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+ConcurrentAVLTree<Key, Value, Compare>::Snapshot::Snapshot(const Snapshot &other)
+    : root(other.root), count(other.count), snapshotVersion(other.snapshotVersion), comp(other.comp) {
+    if (root) {
+        const_cast<Node *>(root)->refs.fetch_add(1);
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+ConcurrentAVLTree<Key, Value, Compare>::Snapshot::Snapshot(Snapshot &&other) noexcept
+    : root(std::exchange(other.root, nullptr)), count(std::exchange(other.count, 0)),
+      snapshotVersion(other.snapshotVersion), comp(other.comp) {
+}
+
+template<typename Key, typename Value, typename Compare>
+auto ConcurrentAVLTree<Key, Value, Compare>::Snapshot::operator=(Snapshot other) noexcept -> Snapshot & {
+    std::swap(root, other.root);
+    std::swap(count, other.count);
+    std::swap(snapshotVersion, other.snapshotVersion);
+    std::swap(comp, other.comp);
+    return *this;
+}
+
+template<typename Key, typename Value, typename Compare>
+ConcurrentAVLTree<Key, Value, Compare>::Snapshot::~Snapshot() {
+    // readers of the live tree never depend on a snapshot's reference, so
+    // there is nothing to wait for
+    release(const_cast<Node *>(root));
+}
+
+template<typename Key, typename Value, typename Compare>
+bool ConcurrentAVLTree<Key, Value, Compare>::Snapshot::contains(KeyParam key) const {
+    return findIn(root, key, comp) != nullptr;
+}
+
+template<typename Key, typename Value, typename Compare>
+std::optional<Value> ConcurrentAVLTree<Key, Value, Compare>::Snapshot::get(KeyParam key) const {
+    if (const Node *node = findIn(root, key, comp)) {
+        return node->entry.second;
+    }
+    return std::nullopt;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K> requires TransparentCompare<Compare>
+bool ConcurrentAVLTree<Key, Value, Compare>::Snapshot::contains(const K &key) const {
+    return findIn(root, key, comp) != nullptr;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K> requires TransparentCompare<Compare>
+std::optional<Value> ConcurrentAVLTree<Key, Value, Compare>::Snapshot::get(const K &key) const {
+    if (const Node *node = findIn(root, key, comp)) {
+        return node->entry.second;
+    }
+    return std::nullopt;
+}
+
+template<typename Key, typename Value, typename Compare>
+std::vector<Key> ConcurrentAVLTree<Key, Value, Compare>::Snapshot::findRange(const Key &lowKey,
+                                                                             const Key &highKey) const {
+    std::vector<Key> keys;
+    forEachInRange(lowKey, highKey, [&keys](const Key &key, const Value &) {
+        keys.push_back(key);
+    });
+    return keys;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename Visitor>
+size_t ConcurrentAVLTree<Key, Value, Compare>::Snapshot::forEachInRange(KeyParam lowKey, KeyParam highKey,
+                                                                        Visitor &&visit, size_t limit) const {
+    return forEachIn(root, lowKey, highKey, visit, limit, comp);
+}
+
+template<typename Key, typename Value, typename Compare>
+std::vector<Key> ConcurrentAVLTree<Key, Value, Compare>::Snapshot::keys() const {
+    return keysOf(root, count);
+}
+
+template<typename Key, typename Value, typename Compare>
+auto ConcurrentAVLTree<Key, Value, Compare>::Snapshot::begin() const -> const_iterator {
+    const_iterator it;
+    it.pending.reserve(maxDepth);
+    it.pushLeftSpine(root);
+    return it;
+}
+
+template<typename Key, typename Value, typename Compare>
+auto ConcurrentAVLTree<Key, Value, Compare>::Snapshot::end() const -> const_iterator {
+    return const_iterator();
+}
+
+template<typename Key, typename Value, typename Compare>
+auto ConcurrentAVLTree<Key, Value, Compare>::Snapshot::const_iterator::operator++() -> const_iterator & {
+    const Node *node = pending.back();
+    pending.pop_back();
+    pushLeftSpine(node->right);
+    return *this;
+}
+
+template<typename Key, typename Value, typename Compare>
+void ConcurrentAVLTree<Key, Value, Compare>::Snapshot::const_iterator::pushLeftSpine(const Node *node) {
+    for (; node; node = node->left) {
+        pending.push_back(node);
+    }
+}
@@ -0,0 +1,189 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for ConcurrentAVLTree: version reference counts, snapshots and
+epoch reclamation, with readers running against a writer checked against
+std::map. Exits nonzero on the first mismatch; build with
+-fsanitize=address (or thread) to catch what a wrong count frees early.
+ */
+#include "ConcurrentAVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+using namespace std;
+
+using Tree = ConcurrentAVLTree<string, size_t>;
+
+static void checkKeys(const vector<string> &actual, const vector<string> &expected, const string &what) {
+    check(actual == expected, what);
+}
+
+// Removes the root of a tree holding keys, whose root is rootKey, with and
+// without a snapshot of the old version alive across the reclaim.
+static void removeRoot(const vector<string> &keys, const string &rootKey, const string &shape) {
+    vector<string> survivors;
+    for (const string &key : keys) {
+        if (key != rootKey) {
+            survivors.push_back(key);
+        }
+    }
+    vector<string> sortedKeys = keys; // keys() lists in order
+    sort(sortedKeys.begin(), sortedKeys.end());
+    sort(survivors.begin(), survivors.end());
+    for (bool holdSnapshot : {false, true}) {
+        string what = "remove root with " + shape + (holdSnapshot ? ", snapshot held" : "");
+        Tree tree;
+        for (size_t i = 0; i < keys.size(); i++) {
+            tree.insert(keys[i], i);
+        }
+        Tree::Snapshot before;
+        if (holdSnapshot) {
+            before = tree.snapshot();
+        }
+        check(tree.remove(rootKey), what + ": remove");
+        tree.reclaim();
+        checkKeys(tree.keys(), survivors, what + ": keys after reclaim");
+        for (const string &key : survivors) {
+            check(tree.contains(key), what + ": contains " + key);
+        }
+        if (holdSnapshot) {
+            checkKeys(before.keys(), sortedKeys, what + ": snapshot keys");
+            before = Tree::Snapshot(); // drops the old version's last reference
+            tree.reclaim();
+            checkKeys(tree.keys(), survivors, what + ": keys after snapshot release");
+        }
+        // the surviving nodes must still carry their own references through
+        // further writes and another round of reclaiming
+        Tree::Snapshot after = tree.snapshot();
+        tree.insert("x", 0);
+        for (const string &key : survivors) {
+            tree.remove(key);
+        }
+        tree.reclaim();
+        checkKeys(after.keys(), survivors, what + ": later snapshot keys");
+        checkKeys(tree.keys(), {"x"}, what + ": final keys");
+    }
+}
+
+// zero padded, so keys order like their numbers
+static string keyOf(size_t number) {
+    string digits = to_string(number);
+    return "k" + string(6 - digits.size(), '0') + digits;
+}
+
+static size_t numberOf(const string &key) {
+    return stoul(key.substr(1));
+}
+
+// One writer inserts, overwrites and removes at random against a std::map
+// while reader threads look up, scan and take snapshots. Every value is its
+// key's number times 1000 plus a write count, so readers can check what they
+// see without the reference. Snapshots taken by the writer are compared with
+// the reference as of that moment after many later writes and reclaims.
+static void stress() {
+    constexpr size_t keySpace = 2000;
+    constexpr size_t writes = 200000;
+    constexpr int readerCount = 3;
+    Tree tree;
+    map<string, size_t> reference;
+    atomic<bool> done{false};
+
+    vector<thread> readers;
+    for (int r = 0; r < readerCount; r++) {
+        readers.emplace_back([&tree, &done, r] {
+            mt19937 random(r);
+            while (!done.load()) {
+                string key = keyOf(random() % keySpace);
+                optional<size_t> value = tree.get(key);
+                check(!value || *value / 1000 == numberOf(key), "reader get " + key);
+                vector<string> range = tree.findRange(keyOf(100), keyOf(300));
+                check(is_sorted(range.begin(), range.end()), "reader findRange order");
+                Tree::Snapshot view = tree.snapshot();
+                size_t seen = 0;
+                string last;
+                for (const auto &[snapshotKey, snapshotValue] : view) {
+                    check(seen == 0 || last < snapshotKey, "reader snapshot order");
+                    check(snapshotValue / 1000 == numberOf(snapshotKey), "reader snapshot value");
+                    last = snapshotKey;
+                    seen++;
+                }
+                check(seen == view.size(), "reader snapshot size");
+            }
+        });
+    }
+
+    vector<pair<Tree::Snapshot, map<string, size_t> > > held;
+    mt19937 random(42);
+    for (size_t i = 0; i < writes; i++) {
+        size_t number = random() % keySpace;
+        string key = keyOf(number);
+        size_t value = number * 1000 + i % 1000;
+        switch (random() % 4) {
+            case 0:
+                check(tree.insert(key, value) == reference.emplace(key, value).second, "insert " + key);
+                break;
+            case 1:
+                check(tree.insert_or_assign(key, value) == !reference.count(key), "insert_or_assign " + key);
+                reference[key] = value;
+                break;
+            default:
+                check(tree.remove(key) == (reference.erase(key) == 1), "remove " + key);
+                break;
+        }
+        if (i % 10000 == 0) {
+            held.emplace_back(tree.snapshot(), reference);
+        }
+        if (i % 1000 == 0) {
+            tree.reclaim();
+        }
+        if (i % 50000 == 0) {
+            tree.clear();
+            reference.clear();
+        }
+    }
+    done.store(true);
+    for (thread &reader : readers) {
+        reader.join();
+    }
+    tree.reclaim();
+
+    check(tree.size() == reference.size(), "final size");
+    auto expected = reference.begin();
+    for (const auto &[key, value] : tree.snapshot()) {
+        check(key == expected->first && value == expected->second, "final entry " + key);
+        ++expected;
+    }
+    for (const auto &[snapshot, then] : held) {
+        check(snapshot.size() == then.size(), "held snapshot size");
+        auto entry = then.begin();
+        for (const auto &[key, value] : snapshot) {
+            check(key == entry->first && value == entry->second, "held snapshot entry " + key);
+            ++entry;
+        }
+    }
+}
+
+int main() {
+    removeRoot({"a"}, "a", "no children");
+    removeRoot({"a", "b"}, "a", "a right child");
+    removeRoot({"b", "a"}, "b", "a left child");
+    removeRoot({"b", "a", "c"}, "b", "two children");
+    removeRoot({"d", "b", "f", "a", "c", "e", "g"}, "d", "two full subtrees");
+    cout << "root removal: ok" << endl;
+    stress();
+    cout << "stress: ok" << endl;
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+#include "EpochDomain.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+    // gives the thread's participant back to the domain when the thread exits
+    template<typename Participant>
+    struct Registration {
+        Participant *participant = nullptr;
+
+        ~Registration() {
+            if (participant) {
+                participant->inUse.store(false);
+            }
+        }
+    };
+}
+
+EpochDomain::Guard::Guard() {
+    EpochDomain &domain = instance();
+    domain.enter(domain.local());
+}
+
+EpochDomain::Guard::~Guard() {
+    EpochDomain &domain = instance();
+    domain.leave(domain.local());
+}
+
+EpochDomain &EpochDomain::instance() {
+    static EpochDomain domain;
+    return domain;
+}
+
+std::uint64_t EpochDomain::currentEpoch() const {
+    return globalEpoch.load();
+}
+
+void EpochDomain::advance() {
+    globalEpoch.fetch_add(1);
+}
+
+std::uint64_t EpochDomain::safeEpoch() const {
+    // everything here is sequentially consistent: a reader announces, then
+    // re-reads the global epoch, then loads the root; a writer publishes the root,
+    // then advances, then scans. A reader the scan misses therefore re-reads an
+    // epoch at least as new as the one read here and never sees the old nodes
+    std::uint64_t safe = globalEpoch.load();
+    for (Participant *p = participants.load(); p; p = p->next) {
+        std::uint64_t announced = p->announced.load();
+        if (announced != 0) {
+            safe = std::min(safe, announced);
+        }
+    }
+    return safe;
+}
+
+EpochDomain::Participant &EpochDomain::local() {
+    thread_local Registration<Participant> registration;
+    if (registration.participant) {
+        return *registration.participant;
+    }
+    // reuse a slot left behind by an exited thread before growing the list
+    for (Participant *p = participants.load(); p; p = p->next) {
+        bool expected = false;
+        if (!p->inUse.load() && p->inUse.compare_exchange_strong(expected, true)) {
+            registration.participant = p;
+            return *p;
+        }
+    }
+    Participant *fresh = new Participant;
+    fresh->inUse.store(true);
+    Participant *head = participants.load();
+    do {
+        fresh->next = head;
+    } while (!participants.compare_exchange_weak(head, fresh));
+    registration.participant = fresh;
+    return *fresh;
+}
+
+void EpochDomain::enter(Participant &self) {
+    if (self.depth++ > 0) {
+        return;
+    }
+    // announce, then make sure the epoch did not move in between; once this
+    // settles the announcement is one a concurrent scan is bound to respect
+    std::uint64_t epoch = globalEpoch.load();
+    for (;;) {
+        self.announced.store(epoch);
+        std::uint64_t now = globalEpoch.load();
+        if (now == epoch) {
+            return;
+        }
+        epoch = now;
+    }
+}
+
+void EpochDomain::leave(Participant &self) {
+    if (--self.depth == 0) {
+        self.announced.store(0);
+    }
+}
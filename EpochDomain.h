@@ -0,0 +1,77 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * EpochDomain.h
+ */
+
+#ifndef EPOCHDOMAIN_H
+#define EPOCHDOMAIN_H
+#include <atomic>
+#include <cstdint>
+
+// Epoch-based reclamation shared by every concurrent tree in the process.
+// Readers wrap each traversal in a Guard, which announces the epoch the thread
+// is reading in: one store to a cache line only that thread writes, no locks.
+// A writer that unlinks memory tags it with currentEpoch(), and may free it once
+// safeEpoch() has moved past the tag, because by then every reader that could
+// still have reached it has left its critical section.
+class EpochDomain {
+public:
+    // marks the calling thread as reading for its lifetime; guards nest
+    class Guard {
+    public:
+        Guard();
+
+        Guard(const Guard &) = delete;
+
+        Guard &operator=(const Guard &) = delete;
+
+        ~Guard();
+    };
+
+    static EpochDomain &instance();
+
+    EpochDomain(const EpochDomain &) = delete;
+
+    EpochDomain &operator=(const EpochDomain &) = delete;
+
+    // the tag for memory unlinked now, read after the new state was published
+    std::uint64_t currentEpoch() const;
+
+    // moves the global epoch forward so readers that start from now on are
+    // known not to hold anything retired before this call
+    void advance();
+
+    // memory retired with a tag below this is no longer reachable by any reader
+    std::uint64_t safeEpoch() const;
+
+private:
+    // one per thread that has ever read, recycled when the thread exits
+    struct alignas(64) Participant {
+        std::atomic<std::uint64_t> announced{0}; // 0 while not reading
+        std::atomic<bool> inUse{false};
+        Participant *next = nullptr;
+        unsigned depth = 0; // nesting level of guards, touched only by the owner
+    };
+
+    friend class Guard;
+
+    std::atomic<std::uint64_t> globalEpoch{1};
+    std::atomic<Participant *> participants{nullptr};
+
+    EpochDomain() = default;
+
+    // the calling thread's participant, claimed on its first read
+    Participant &local();
+
+    void enter(Participant &self);
+
+    void leave(Participant &self);
+};
+
+#endif //EPOCHDOMAIN_H
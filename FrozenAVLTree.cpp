@@ -0,0 +1,100 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+#include "FrozenAVLTree.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FROZENAVLTREE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string &path) {
+#ifdef FROZENAVLTREE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("cannot stat " + path + ": " + std::strerror(error));
+    }
+    length = size_t(info.st_size);
+    if (length > 0) {
+        void *address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) {
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("cannot map " + path + ": " + std::strerror(error));
+        }
+        bytes = static_cast<const std::byte *>(address);
+        mapped = true;
+    }
+    // the mapping keeps the file alive on its own
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    length = size_t(in.tellg());
+    std::byte *buffer = new std::byte[length];
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char *>(buffer), std::streamsize(length))) {
+        delete[] buffer;
+        throw std::runtime_error("cannot read " + path);
+    }
+    bytes = buffer;
+#endif
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : bytes(std::exchange(other.bytes, nullptr)), length(std::exchange(other.length, 0)),
+      mapped(std::exchange(other.mapped, false)) {
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        release();
+        bytes = std::exchange(other.bytes, nullptr);
+        length = std::exchange(other.length, 0);
+        mapped = std::exchange(other.mapped, false);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+void MappedFile::release() noexcept {
+#ifdef FROZENAVLTREE_MMAP
+    if (mapped) {
+        ::munmap(const_cast<std::byte *>(bytes), length);
+    } else {
+        delete[] bytes;
+    }
+#else
+    delete[] bytes;
+#endif
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+}
+
+// the default string -> size_t layout is compiled once here
+template class FrozenAVLTree<std::string, size_t>;
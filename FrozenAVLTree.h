@@ -0,0 +1,164 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * FrozenAVLTree.h
+ */
+
+#ifndef FROZENAVLTREE_H
+#define FROZENAVLTREE_H
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "KeyCompare.h"
+
+// A read-only file mapped into memory, or read into a buffer where mmap is
+// not available. Move-only, unmapped on destruction.
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    // throws std::runtime_error if path cannot be opened or mapped
+    explicit MappedFile(const std::string &path);
+
+    MappedFile(MappedFile &&other) noexcept;
+
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile();
+
+    const std::byte *data() const { return bytes; }
+
+    size_t size() const { return length; }
+
+private:
+    const std::byte *bytes = nullptr;
+    size_t length = 0;
+    bool mapped = false; // false when bytes came from new[]
+
+    void release() noexcept;
+};
+
+// Immutable snapshot of a map in a pointer-free file layout that is used in
+// place once mapped: opening costs one mmap and a header check whatever the
+// size, and pages are read from disk only as lookups touch them.
+//
+// Entries are stored in key order, the in-order layout of a perfectly balanced
+// tree whose root is the middle entry, so a lookup is the same O(log n)
+// descent AVLTree makes, by index instead of by pointer. String keys keep
+// their first 8 bytes in a 24-byte record next to the offset and length of
+// the full key, so most steps never leave the record array; the key bytes and
+// values live in separate sections after it.
+//
+// Keys are std::string in byte order or a trivially copyable type under
+// std::less; values are trivially copyable. Files are written in native byte
+// order and rejected by a machine that differs.
+template<typename Key = std::string, typename Value = size_t>
+class FrozenAVLTree {
+    static_assert(std::is_trivially_copyable_v<Value>, "FrozenAVLTree values are stored as raw bytes");
+    static_assert(std::is_same_v<Key, std::string> || std::is_trivially_copyable_v<Key>,
+                  "FrozenAVLTree keys are std::string or stored as raw bytes");
+
+public:
+    static constexpr bool stringKeys = std::is_same_v<Key, std::string>;
+
+    // what lookups accept and visitors receive: a view into the mapping for
+    // string keys, the key itself otherwise
+    using KeyView = std::conditional_t<stringKeys, std::string_view, Key>;
+
+    FrozenAVLTree() = default;
+
+    // maps a file written by write; throws std::runtime_error when it is
+    // missing, truncated or was written for other key or value types
+    explicit FrozenAVLTree(const std::string &path);
+
+    // Writes entries, a range of (key, value) pairs in strictly increasing key
+    // order such as an AVLTree with the default comparator, to path. Throws
+    // std::invalid_argument if the order is wrong; like AVLTree::save, the file
+    // is written beside path and renamed over it.
+    template<std::ranges::forward_range Entries>
+    static void write(const std::string &path, const Entries &entries);
+
+    bool contains(KeyView key) const;
+
+    std::optional<Value> get(KeyView key) const;
+
+    // copies of every key in [lowKey, highKey], in order
+    std::vector<Key> findRange(KeyView lowKey, KeyView highKey) const;
+
+    // calls visit(key, value) for entries with keys in [lowKey, highKey] in
+    // ascending order, stopping after limit entries or when visit returns false
+    template<typename Visitor>
+    size_t forEachInRange(KeyView lowKey, KeyView highKey, Visitor &&visit,
+                          size_t limit = std::numeric_limits<size_t>::max()) const;
+
+    size_t size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+private:
+    // section offsets are from the start of the file
+    struct Header {
+        char magic[8];
+        std::uint32_t byteOrderMark;
+        std::uint32_t keySize; // 0 for string keys
+        std::uint32_t valueSize;
+        std::uint32_t reserved;
+        std::uint64_t entryCount;
+        std::uint64_t indexOffset; // StringRecord or Key per entry
+        std::uint64_t valuesOffset; // Value per entry
+        std::uint64_t bytesOffset; // concatenated string keys
+        std::uint64_t fileSize;
+    };
+
+    struct StringRecord {
+        std::uint64_t prefix; // first 8 key bytes big-endian, zero padded
+        std::uint64_t offset; // into the key bytes section
+        std::uint64_t length;
+    };
+
+    static constexpr char magic[8] = {'A', 'V', 'L', 'F', 'R', 'Z', 'N', '1'};
+
+    using IndexEntry = std::conditional_t<stringKeys, StringRecord, Key>;
+
+    MappedFile file;
+    size_t count = 0;
+    const IndexEntry *index = nullptr;
+    const Value *values = nullptr;
+    const char *keyBytes = nullptr;
+    size_t keyBytesSize = 0;
+
+    static std::uint64_t prefixOf(std::string_view key);
+
+    // section offsets for count entries and totalKeyBytes bytes of string keys
+    static Header layout(size_t count, std::uint64_t totalKeyBytes);
+
+    KeyView keyAt(size_t i) const;
+
+    // negative, zero or positive as key orders before, equal to or after entry i
+    int compareAt(size_t i, KeyView key, std::uint64_t keyPrefix) const;
+
+    // first entry whose key is not less than key, count if none
+    size_t lowerBound(KeyView key) const;
+};
+
+#include "FrozenAVLTree.tpp"
+
+extern template class FrozenAVLTree<std::string, size_t>;
+
+#endif //FROZENAVLTREE_H
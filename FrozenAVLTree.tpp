@@ -0,0 +1,251 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * FrozenAVLTree.tpp
+ * Member definitions for FrozenAVLTree, included at the bottom of FrozenAVLTree.h.
+ */
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include "BinaryCodec.h"
+
+template<typename Key, typename Value>
+FrozenAVLTree<Key, Value>::FrozenAVLTree(const std::string &path) : file(path) {
+    Header header;
+    if (file.size() < sizeof(Header)) {
+        throw std::runtime_error(path + " is not a FrozenAVLTree file");
+    }
+    std::memcpy(&header, file.data(), sizeof(Header));
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+        throw std::runtime_error(path + " is not a FrozenAVLTree file");
+    }
+    if (header.byteOrderMark != binaryByteOrderMark) {
+        throw std::runtime_error(path + " was written with the other byte order");
+    }
+    if (header.keySize != (stringKeys ? 0 : sizeof(Key)) || header.valueSize != sizeof(Value)) {
+        throw std::runtime_error(path + " holds other key or value types");
+    }
+    // the offsets must be exactly the ones write would pick for this count,
+    // which also keeps every section inside the file; bounding the count first
+    // keeps that arithmetic from overflowing
+    if (header.entryCount > file.size() / sizeof(IndexEntry) || header.fileSize != file.size()) {
+        throw std::runtime_error(path + " is truncated or corrupt");
+    }
+    Header expected = layout(size_t(header.entryCount), 0);
+    if (header.indexOffset != expected.indexOffset || header.valuesOffset != expected.valuesOffset ||
+        header.bytesOffset != expected.bytesOffset || header.bytesOffset > header.fileSize) {
+        throw std::runtime_error(path + " is truncated or corrupt");
+    }
+    count = size_t(header.entryCount);
+    index = reinterpret_cast<const IndexEntry *>(file.data() + header.indexOffset);
+    values = reinterpret_cast<const Value *>(file.data() + header.valuesOffset);
+    keyBytes = reinterpret_cast<const char *>(file.data() + header.bytesOffset);
+    keyBytesSize = size_t(header.fileSize - header.bytesOffset);
+}
+
+template<typename Key, typename Value>
+auto FrozenAVLTree<Key, Value>::layout(size_t count, std::uint64_t totalKeyBytes) -> Header {
+    auto alignUp = [](std::uint64_t offset, std::uint64_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    };
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.byteOrderMark = binaryByteOrderMark;
+    header.keySize = stringKeys ? 0 : sizeof(Key);
+    header.valueSize = sizeof(Value);
+    header.entryCount = count;
+    header.indexOffset = alignUp(sizeof(Header), alignof(IndexEntry));
+    header.valuesOffset = alignUp(header.indexOffset + count * sizeof(IndexEntry), alignof(Value));
+    header.bytesOffset = header.valuesOffset + count * sizeof(Value);
+    header.fileSize = header.bytesOffset + totalKeyBytes;
+    return header;
+}
+
+template<typename Key, typename Value>
+template<std::ranges::forward_range Entries>
+void FrozenAVLTree<Key, Value>::write(const std::string &path, const Entries &entries) {
+    // first pass counts, checks the order and sizes the key bytes section
+    size_t entryCount = 0;
+    std::uint64_t totalKeyBytes = 0;
+    for (auto it = std::ranges::begin(entries), previous = it; it != std::ranges::end(entries); previous = it, ++it) {
+        const Key &key = (*it).first;
+        if (entryCount > 0) {
+            const Key &previousKey = (*previous).first;
+            bool increasing;
+            if constexpr (stringKeys) {
+                increasing = KeyCompare::compare(previousKey, key) < 0;
+            } else {
+                increasing = std::less<Key>()(previousKey, key);
+            }
+            if (!increasing) {
+                throw std::invalid_argument("FrozenAVLTree::write needs keys in strictly increasing order");
+            }
+        }
+        if constexpr (stringKeys) {
+            totalKeyBytes += key.size();
+        }
+        entryCount++;
+    }
+
+    Header header = layout(entryCount, totalKeyBytes);
+    std::string partial = path + ".tmp";
+    {
+        std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("cannot create " + partial);
+        }
+        auto padTo = [&out](std::uint64_t offset) {
+            static constexpr char zeros[64] = {};
+            for (auto at = std::uint64_t(out.tellp()); at < offset; at = std::uint64_t(out.tellp())) {
+                writeBytes(out, zeros, size_t(std::min<std::uint64_t>(sizeof(zeros), offset - at)));
+            }
+        };
+        // one more pass per section, so nothing is buffered
+        writeBytes(out, &header, sizeof(Header));
+        padTo(header.indexOffset);
+        std::uint64_t keyOffset = 0;
+        for (const auto &entry : entries) {
+            if constexpr (stringKeys) {
+                StringRecord record{prefixOf(entry.first), keyOffset, entry.first.size()};
+                writeBytes(out, &record, sizeof(record));
+                keyOffset += entry.first.size();
+            } else {
+                Key key = entry.first;
+                writeBytes(out, &key, sizeof(Key));
+            }
+        }
+        padTo(header.valuesOffset);
+        for (const auto &entry : entries) {
+            Value value = entry.second;
+            writeBytes(out, &value, sizeof(Value));
+        }
+        if constexpr (stringKeys) {
+            for (const auto &entry : entries) {
+                writeBytes(out, entry.first.data(), entry.first.size());
+            }
+        }
+        out.close();
+        if (!out) {
+            throw std::runtime_error("writing " + partial + " failed");
+        }
+    }
+    std::filesystem::rename(partial, path);
+}
+
+template<typename Key, typename Value>
+std::uint64_t FrozenAVLTree<Key, Value>::prefixOf(std::string_view key) {
+    std::uint64_t prefix = 0;
+    size_t length = std::min<size_t>(key.size(), 8);
+    for (size_t i = 0; i < length; i++) {
+        prefix |= std::uint64_t(static_cast<unsigned char>(key[i])) << (56 - 8 * i);
+    }
+    return prefix;
+}
+
+template<typename Key, typename Value>
+auto FrozenAVLTree<Key, Value>::keyAt(size_t i) const -> KeyView {
+    if constexpr (stringKeys) {
+        // records are not checked on open, that would read the whole file, so
+        // each one is bounds checked as it is used
+        const StringRecord &record = index[i];
+        if (record.offset > keyBytesSize || record.length > keyBytesSize - record.offset) {
+            throw std::runtime_error("corrupt FrozenAVLTree key record");
+        }
+        return std::string_view(keyBytes + record.offset, size_t(record.length));
+    } else {
+        return index[i];
+    }
+}
+
+template<typename Key, typename Value>
+int FrozenAVLTree<Key, Value>::compareAt(size_t i, KeyView key, std::uint64_t keyPrefix) const {
+    if constexpr (stringKeys) {
+        std::uint64_t entryPrefix = index[i].prefix;
+        if (keyPrefix != entryPrefix) {
+            return keyPrefix < entryPrefix ? -1 : 1;
+        }
+        // equal prefixes mean the bytes both keys have among the first 8 match
+        size_t common;
+        return KeyCompare::compare(key, keyAt(i), 8, common);
+    } else {
+        std::less<Key> less;
+        return less(key, index[i]) ? -1 : (less(index[i], key) ? 1 : 0);
+    }
+}
+
+template<typename Key, typename Value>
+size_t FrozenAVLTree<Key, Value>::lowerBound(KeyView key) const {
+    std::uint64_t keyPrefix = 0;
+    if constexpr (stringKeys) {
+        keyPrefix = prefixOf(key);
+    }
+    // halving [low, high) visits the nodes of the implicit balanced tree from
+    // the root down
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (compareAt(middle, key, keyPrefix) > 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+template<typename Key, typename Value>
+bool FrozenAVLTree<Key, Value>::contains(KeyView key) const {
+    size_t i = lowerBound(key);
+    return i < count && keyAt(i) == key;
+}
+
+template<typename Key, typename Value>
+std::optional<Value> FrozenAVLTree<Key, Value>::get(KeyView key) const {
+    size_t i = lowerBound(key);
+    if (i < count && keyAt(i) == key) {
+        return values[i];
+    }
+    return std::nullopt;
+}
+
+template<typename Key, typename Value>
+std::vector<Key> FrozenAVLTree<Key, Value>::findRange(KeyView lowKey, KeyView highKey) const {
+    std::vector<Key> keys;
+    forEachInRange(lowKey, highKey, [&keys](KeyView key, const Value &) {
+        keys.emplace_back(key);
+    });
+    return keys;
+}
+
+template<typename Key, typename Value>
+template<typename Visitor>
+size_t FrozenAVLTree<Key, Value>::forEachInRange(KeyView lowKey, KeyView highKey, Visitor &&visit,
+                                                 size_t limit) const {
+    if (highKey < lowKey) {
+        return 0;
+    }
+    size_t visited = 0;
+    for (size_t i = lowerBound(lowKey); i < count && visited < limit; i++) {
+        KeyView key = keyAt(i);
+        if (highKey < key) {
+            break; // walked out of the range
+        }
+        visited++;
+        if constexpr (std::is_same_v<std::invoke_result_t<Visitor &, KeyView, const Value &>, bool>) {
+            if (!visit(key, values[i])) {
+                break; // visitor asked to stop
+            }
+        } else {
+            visit(key, values[i]);
+        }
+    }
+    return visited;
+}
@@ -0,0 +1,149 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * JournaledAVLTree.h
+ */
+
+#ifndef JOURNALEDAVLTREE_H
+#define JOURNALEDAVLTREE_H
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include "AVLTree.h"
+#include "BinaryCodec.h"
+#include "WriteAheadLog.h"
+
+// AVLTree whose writes survive a crash. Every write that changes the tree is
+// appended to a write-ahead journal in its directory, and the journal is
+// group-committed by WriteAheadLog. A checkpoint saves the whole tree
+// (AVLTree::save plus the journal sequence it covers) and empties the
+// journal. Opening the directory again loads the checkpoint with the O(n)
+// balanced build, then replays the journal records after it.
+//
+// By default a write returns once its record is buffered, so logging costs
+// well under a microsecond and a crash loses at most the last commit interval
+// of writes. With waitForDurable set, each write waits until it is on disk;
+// concurrent writers then share each fsync. Once a commit has failed, every
+// write throws before it touches the tree. A write that passed that check
+// while the failing commit was still running is applied but its record is
+// lost, like one buffered just before the commit; waitForDurable reports it.
+//
+// Writers are serialized by a lock and readers share it. operator[] cannot be
+// journaled, since the caller changes the value after it returns; update()
+// takes its place.
+template<typename Key = std::string, typename Value = size_t, typename Compare = std::less<> >
+class JournaledAVLTree {
+    static_assert(BinarySerializable<Key> && BinarySerializable<Value>,
+                  "journaled keys and values need a BinaryCodec");
+
+public:
+    using Tree = AVLTree<Key, Value, Compare>;
+    using KeyParam = typename Tree::KeyParam;
+
+    struct Options {
+        WriteAheadLog::Options log;
+        // each write waits until its record is on disk
+        bool waitForDurable = false;
+        // journal size that triggers a checkpoint, 0 to checkpoint only on request
+        std::uint64_t checkpointBytes = std::uint64_t(64) << 20;
+    };
+
+    // opens directory, creating it if needed, and recovers the tree from the
+    // checkpoint and journal in it; throws std::runtime_error on a corrupt
+    // checkpoint (a torn journal tail is expected after a crash and dropped)
+    explicit JournaledAVLTree(const std::string &directory, Options options = Options(),
+                              const Compare &comp = Compare());
+
+    JournaledAVLTree(const JournaledAVLTree &) = delete;
+
+    JournaledAVLTree &operator=(const JournaledAVLTree &) = delete;
+
+    // writes still buffered are committed before the journal closes
+    ~JournaledAVLTree() = default;
+
+    bool insert(KeyParam key, const Value &value);
+
+    // true if key was inserted, false if an existing value was replaced
+    bool insert_or_assign(KeyParam key, const Value &value);
+
+    bool remove(KeyParam key);
+
+    // journaled operator[]: calls fn(value&) on key's value, default-constructed
+    // if key is missing, stores and logs the result and returns it
+    template<typename Fn>
+    Value update(KeyParam key, Fn &&fn);
+
+    void clear();
+
+    bool contains(KeyParam key) const;
+
+    std::optional<Value> get(KeyParam key) const;
+
+    size_t size() const;
+
+    bool empty() const;
+
+    // runs fn(const Tree &) with the tree locked for reading, for everything
+    // else AVLTree offers (ranges, iteration, rank, ...)
+    template<typename Fn>
+    decltype(auto) read(Fn &&fn) const;
+
+    // saves the tree, makes the checkpoint durable and empties the journal
+    void checkpoint();
+
+    // waits until every write so far is on disk
+    void sync();
+
+    // sequence number of the latest journaled write
+    std::uint64_t lastSequence() const;
+
+private:
+    enum class Op : std::uint8_t {
+        insert = 1, assign = 2, remove = 3, clear = 4
+    };
+
+    static constexpr char checkpointMagic[8] = {'A', 'V', 'L', 'C', 'K', 'P', 'T', '1'};
+
+    std::string directory;
+    Options options;
+
+    mutable std::shared_mutex lock;
+    Tree tree;
+    std::ostringstream record; // encoding buffer reused by writers, guarded by lock
+    std::unique_ptr<WriteAheadLog> journal; // declared last, so it closes first
+
+    std::string checkpointPath() const;
+
+    std::string journalPath() const;
+
+    // loads the checkpoint if there is one, returns the last sequence it covers
+    std::uint64_t loadCheckpoint();
+
+    // replays one journal record
+    void apply(std::string_view payload);
+
+    // starts a record in the shared buffer
+    void encode(Op op, KeyParam key, const Value *value);
+
+    // durability wait and checkpoint check after a write, outside the lock
+    void afterWrite(std::uint64_t sequence);
+
+    void checkpointLocked();
+};
+
+#include "JournaledAVLTree.tpp"
+
+extern template class JournaledAVLTree<std::string, size_t>;
+
+#endif //JOURNALEDAVLTREE_H
@@ -0,0 +1,268 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * JournaledAVLTree.tpp
+ * Member definitions for JournaledAVLTree, included at the bottom of JournaledAVLTree.h.
+ */
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+
+template<typename Key, typename Value, typename Compare>
+JournaledAVLTree<Key, Value, Compare>::JournaledAVLTree(const std::string &directory, Options options,
+                                                        const Compare &comp)
+    : directory(directory), options(options), tree(comp) {
+    std::filesystem::create_directories(directory);
+    std::uint64_t covered = loadCheckpoint();
+    // records up to the checkpoint's sequence are already in the tree; they
+    // are still in the journal when a crash hit between the two steps of
+    // checkpoint()
+    WriteAheadLog::ReadResult existing = WriteAheadLog::read(journalPath(),
+        [&](std::uint64_t sequence, std::string_view payload) {
+            if (sequence > covered) {
+                apply(payload);
+            }
+        });
+    existing.lastSequence = std::max(existing.lastSequence, covered);
+    journal = std::make_unique<WriteAheadLog>(journalPath(), options.log, existing);
+}
+
+template<typename Key, typename Value, typename Compare>
+std::string JournaledAVLTree<Key, Value, Compare>::checkpointPath() const {
+    return (std::filesystem::path(directory) / "checkpoint").string();
+}
+
+template<typename Key, typename Value, typename Compare>
+std::string JournaledAVLTree<Key, Value, Compare>::journalPath() const {
+    return (std::filesystem::path(directory) / "journal").string();
+}
+
+template<typename Key, typename Value, typename Compare>
+std::uint64_t JournaledAVLTree<Key, Value, Compare>::loadCheckpoint() {
+    std::ifstream in(checkpointPath(), std::ios::binary);
+    if (!in) {
+        return 0; // a fresh directory
+    }
+    char magic[sizeof(checkpointMagic)];
+    readBytes(in, magic, sizeof(magic), "the checkpoint header");
+    if (std::memcmp(magic, checkpointMagic, sizeof(magic)) != 0 ||
+        BinaryCodec<std::uint32_t>::read(in) != binaryByteOrderMark) {
+        throw std::runtime_error(checkpointPath() + " is not a JournaledAVLTree checkpoint");
+    }
+    std::uint64_t covered = BinaryCodec<std::uint64_t>::read(in);
+    tree.load(in);
+    return covered;
+}
+
+template<typename Key, typename Value, typename Compare>
+void JournaledAVLTree<Key, Value, Compare>::apply(std::string_view payload) {
+    std::istringstream in{std::string(payload)};
+    auto op = Op(BinaryCodec<std::uint8_t>::read(in));
+    if (op == Op::clear) {
+        tree.clear();
+        return;
+    }
+    Key key = BinaryCodec<Key>::read(in);
+    switch (op) {
+        case Op::insert:
+            tree.insert(key, BinaryCodec<Value>::read(in));
+            break;
+        case Op::assign:
+            tree.insert_or_assign(key, BinaryCodec<Value>::read(in));
+            break;
+        case Op::remove:
+            tree.remove(key);
+            break;
+        default:
+            throw std::runtime_error("unknown JournaledAVLTree journal record");
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+void JournaledAVLTree<Key, Value, Compare>::encode(Op op, KeyParam key, const Value *value) {
+    record.str(std::string());
+    BinaryCodec<std::uint8_t>::write(record, std::uint8_t(op));
+    BinaryCodec<Key>::write(record, key);
+    if (value) {
+        BinaryCodec<Value>::write(record, *value);
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+void JournaledAVLTree<Key, Value, Compare>::afterWrite(std::uint64_t sequence) {
+    if (options.waitForDurable) {
+        journal->waitDurable(sequence); // writers arriving meanwhile join the same fsync
+    }
+    if (options.checkpointBytes > 0 && journal->sizeBytes() >= options.checkpointBytes) {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        // another writer may have checkpointed while we waited for the lock
+        if (journal->sizeBytes() >= options.checkpointBytes) {
+            checkpointLocked();
+        }
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+bool JournaledAVLTree<Key, Value, Compare>::insert(KeyParam key, const Value &value) {
+    std::uint64_t sequence;
+    {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        // encoded and the journal checked before the tree changes, so a throw
+        // leaves both untouched; append cannot throw once the tree has changed
+        encode(Op::insert, key, &value);
+        journal->checkUsable();
+        if (!tree.insert(key, value)) {
+            return false; // nothing changed, nothing to log
+        }
+        sequence = journal->append(record.view());
+    }
+    afterWrite(sequence);
+    return true;
+}
+
+template<typename Key, typename Value, typename Compare>
+bool JournaledAVLTree<Key, Value, Compare>::insert_or_assign(KeyParam key, const Value &value) {
+    std::uint64_t sequence;
+    bool inserted;
+    {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        encode(Op::assign, key, &value);
+        journal->checkUsable();
+        inserted = tree.insert_or_assign(key, value).second;
+        sequence = journal->append(record.view());
+    }
+    afterWrite(sequence);
+    return inserted;
+}
+
+template<typename Key, typename Value, typename Compare>
+bool JournaledAVLTree<Key, Value, Compare>::remove(KeyParam key) {
+    std::uint64_t sequence;
+    {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        encode(Op::remove, key, nullptr);
+        journal->checkUsable();
+        if (!tree.remove(key)) {
+            return false;
+        }
+        sequence = journal->append(record.view());
+    }
+    afterWrite(sequence);
+    return true;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename Fn>
+Value JournaledAVLTree<Key, Value, Compare>::update(KeyParam key, Fn &&fn) {
+    std::uint64_t sequence;
+    Value value;
+    {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        // worked on a copy and logged as an assignment, so a throwing fn or
+        // encoder leaves the tree as it was
+        value = tree.get(key).value_or(Value());
+        fn(value);
+        encode(Op::assign, key, &value);
+        journal->checkUsable();
+        tree.insert_or_assign(key, value);
+        sequence = journal->append(record.view());
+    }
+    afterWrite(sequence);
+    return value;
+}
+
+template<typename Key, typename Value, typename Compare>
+void JournaledAVLTree<Key, Value, Compare>::clear() {
+    std::uint64_t sequence;
+    {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        record.str(std::string());
+        BinaryCodec<std::uint8_t>::write(record, std::uint8_t(Op::clear));
+        journal->checkUsable();
+        tree.clear();
+        sequence = journal->append(record.view());
+    }
+    afterWrite(sequence);
+}
+
+template<typename Key, typename Value, typename Compare>
+bool JournaledAVLTree<Key, Value, Compare>::contains(KeyParam key) const {
+    std::shared_lock<std::shared_mutex> guard(lock);
+    return tree.contains(key);
+}
+
+template<typename Key, typename Value, typename Compare>
+std::optional<Value> JournaledAVLTree<Key, Value, Compare>::get(KeyParam key) const {
+    std::shared_lock<std::shared_mutex> guard(lock);
+    return tree.get(key);
+}
+
+template<typename Key, typename Value, typename Compare>
+size_t JournaledAVLTree<Key, Value, Compare>::size() const {
+    std::shared_lock<std::shared_mutex> guard(lock);
+    return tree.size();
+}
+
+template<typename Key, typename Value, typename Compare>
+bool JournaledAVLTree<Key, Value, Compare>::empty() const {
+    return size() == 0;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename Fn>
+decltype(auto) JournaledAVLTree<Key, Value, Compare>::read(Fn &&fn) const {
+    std::shared_lock<std::shared_mutex> guard(lock);
+    return fn(tree);
+}
+
+template<typename Key, typename Value, typename Compare>
+void JournaledAVLTree<Key, Value, Compare>::checkpoint() {
+    std::unique_lock<std::shared_mutex> guard(lock);
+    checkpointLocked();
+}
+
+template<typename Key, typename Value, typename Compare>
+void JournaledAVLTree<Key, Value, Compare>::checkpointLocked() {
+    // no write can run, so the tree holds exactly the records up to covered
+    std::uint64_t covered = journal->lastSequence();
+    std::string partial = checkpointPath() + ".tmp";
+    {
+        std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("cannot create " + partial);
+        }
+        writeBytes(out, checkpointMagic, sizeof(checkpointMagic));
+        BinaryCodec<std::uint32_t>::write(out, binaryByteOrderMark);
+        BinaryCodec<std::uint64_t>::write(out, covered);
+        tree.save(out);
+        out.close();
+        if (!out) {
+            throw std::runtime_error("writing " + partial + " failed");
+        }
+    }
+    // the new checkpoint must be on disk, and its name in the directory,
+    // before the journal records it replaces are dropped
+    WriteAheadLog::syncPath(partial);
+    std::filesystem::rename(partial, checkpointPath());
+    WriteAheadLog::syncPath(directory);
+    journal->reset();
+}
+
+template<typename Key, typename Value, typename Compare>
+void JournaledAVLTree<Key, Value, Compare>::sync() {
+    journal->sync();
+}
+
+template<typename Key, typename Value, typename Compare>
+std::uint64_t JournaledAVLTree<Key, Value, Compare>::lastSequence() const {
+    return journal->lastSequence();
+}
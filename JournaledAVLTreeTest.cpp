@@ -0,0 +1,272 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for JournaledAVLTree recovery, checked against std::map: reopening
+after writes and checkpoints, torn and corrupt journal tails, a crash between
+the checkpoint rename and the journal reset, and a commit failure, which runs
+in a child process with a file size limit.
+ */
+#include "JournaledAVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+using namespace std;
+namespace fs = std::filesystem;
+
+using Journaled = JournaledAVLTree<string, size_t>;
+using Map = map<string, size_t>;
+
+static void checkJournaled(const Journaled &tree, const Map &reference, const string &what) {
+    tree.read([&](const Journaled::Tree &contents) { checkTree(contents, reference, what); });
+}
+
+// one random write applied to both
+static void randomWrite(Journaled &tree, Map &reference, mt19937 &random, size_t i) {
+    string key = "key" + to_string(random() % 500);
+    switch (random() % 10) {
+        case 0:
+            check(tree.remove(key) == (reference.erase(key) == 1), "remove");
+            break;
+        case 1: {
+            bool inserted = !reference.contains(key);
+            reference[key] = i;
+            check(tree.insert_or_assign(key, i) == inserted, "insert_or_assign");
+            break;
+        }
+        case 2:
+            reference[key] += 7;
+            check(tree.update(key, [](size_t &value) { value += 7; }) == reference[key], "update");
+            break;
+        default:
+            check(tree.insert(key, i) == reference.emplace(key, i).second, "insert");
+            break;
+    }
+}
+
+// closing and reopening, with and without automatic checkpoints, loses nothing
+static void reopenAfterWrites(const fs::path &directory) {
+    for (uint64_t checkpointBytes : {uint64_t(0), uint64_t(2048)}) {
+        fs::remove_all(directory);
+        Journaled::Options options;
+        options.checkpointBytes = checkpointBytes;
+        string what = checkpointBytes ? "with checkpoints" : "journal only";
+        mt19937 random(23);
+        Map reference;
+        uint64_t sequence = 0;
+        for (int round = 0; round < 10; round++) {
+            Journaled tree(directory.string(), options);
+            checkJournaled(tree, reference, what + ": reopened");
+            check(tree.lastSequence() >= sequence, what + ": numbering carries on");
+            for (size_t i = 0; i < 400; i++) {
+                randomWrite(tree, reference, random, i);
+            }
+            if (round == 4) {
+                tree.clear();
+                reference.clear();
+            }
+            if (round == 7) {
+                tree.checkpoint();
+            }
+            sequence = tree.lastSequence();
+        }
+        Journaled tree(directory.string(), options);
+        checkJournaled(tree, reference, what + ": final reopen");
+        check(fs::exists(directory / "checkpoint"), what + ": a checkpoint was written");
+    }
+}
+
+// byte offset of the record with this sequence number in the journal
+static uint64_t recordOffset(const fs::path &journal, uint64_t sequence) {
+    uint64_t offset = 0;
+    uint64_t found = 0;
+    WriteAheadLog::read(journal.string(), [&](uint64_t each, string_view payload) {
+        if (each < sequence) {
+            offset += 16 + payload.size();
+        } else if (each == sequence) {
+            found = offset;
+        }
+    });
+    return found;
+}
+
+// a crash mid-write leaves a torn or garbled tail; recovery keeps every record
+// before it and the log carries on from there
+static void tornTails(const fs::path &directory) {
+    fs::remove_all(directory);
+    fs::path journal = directory / "journal";
+    vector<Map> states(1); // states[s] is the content after record s
+    {
+        Journaled tree(directory.string());
+        for (size_t i = 0; i < 60; i++) {
+            // insert_or_assign logs even when it overwrites, so record s is write s
+            string key = "torn" + to_string(i % 40);
+            tree.insert_or_assign(key, i);
+            states.push_back(states.back());
+            states.back()[key] = i;
+        }
+        check(tree.lastSequence() == 60, "one record per write");
+    }
+    uint64_t size = fs::file_size(journal);
+
+    // trailing garbage is dropped without losing a record
+    {
+        ofstream out(journal, ios::binary | ios::app);
+        out << "partial frame";
+    }
+    {
+        Journaled tree(directory.string());
+        checkJournaled(tree, states[60], "garbage after the last record");
+        check(fs::file_size(journal) == size, "garbage cut off");
+    }
+
+    // a record cut short is lost, the ones before it are not
+    fs::resize_file(journal, size - 3);
+    {
+        Journaled tree(directory.string());
+        checkJournaled(tree, states[59], "last record torn");
+        check(tree.lastSequence() == 59, "numbering resumes after the last intact record");
+        tree.insert("after the tear", 1);
+        states[59].emplace("after the tear", 1);
+    }
+    {
+        Journaled tree(directory.string());
+        checkJournaled(tree, states[59], "written after the tear");
+    }
+
+    // a flipped byte mid-journal ends recovery at the record before it
+    uint64_t offset = recordOffset(journal, 30);
+    {
+        fstream file(journal, ios::binary | ios::in | ios::out);
+        file.seekp(streamoff(offset + 20));
+        file.put('\x5a');
+    }
+    Journaled tree(directory.string());
+    checkJournaled(tree, states[29], "corrupt record mid-journal");
+}
+
+// checkpoint() renames the new checkpoint into place, then empties the
+// journal. A crash between the two leaves records the checkpoint already
+// holds; they must not be applied again, and new ones must follow them
+static void crashDuringCheckpoint(const fs::path &directory) {
+    fs::remove_all(directory);
+    fs::path journal = directory / "journal";
+    fs::path saved = directory.string() + "-journal";
+    Map reference;
+    uint64_t covered;
+    {
+        Journaled::Options options;
+        options.checkpointBytes = 0;
+        Journaled tree(directory.string(), options);
+        for (size_t i = 0; i < 100; i++) {
+            string key = "ckpt" + to_string(i % 30);
+            if (i % 4 == 3) {
+                tree.remove(key);
+                reference.erase(key);
+            } else {
+                tree.insert_or_assign(key, i);
+                reference[key] = i;
+            }
+        }
+        tree.sync();
+        fs::copy_file(journal, saved, fs::copy_options::overwrite_existing);
+        tree.checkpoint();
+        covered = tree.lastSequence();
+    }
+    // put back the journal as it was just before the reset
+    fs::copy_file(saved, journal, fs::copy_options::overwrite_existing);
+    fs::remove(saved);
+    {
+        Journaled tree(directory.string());
+        checkJournaled(tree, reference, "checkpoint and its journal both present");
+        check(tree.lastSequence() == covered, "numbering resumes after the checkpoint");
+        tree.remove("ckpt0");
+        tree.insert_or_assign("ckpt1", 1000);
+        reference.erase("ckpt0");
+        reference["ckpt1"] = 1000;
+    }
+    {
+        Journaled tree(directory.string());
+        checkJournaled(tree, reference, "writes after the recovered checkpoint");
+    }
+
+    // a crash before the rename leaves only the partial file, which is ignored
+    {
+        ofstream out(directory / "checkpoint.tmp", ios::binary);
+        out << "half a checkpoint";
+    }
+    Journaled tree(directory.string());
+    checkJournaled(tree, reference, "stale partial checkpoint");
+
+    // a damaged checkpoint is refused rather than loaded partly
+    {
+        fstream file(directory / "checkpoint", ios::binary | ios::in | ios::out);
+        file.put('X');
+    }
+    check(throws<runtime_error>([&] { Journaled reopened(directory.string()); }), "corrupt checkpoint refused");
+}
+
+// once a commit fails every write throws and leaves the tree alone; after a
+// reopen only what reached the disk is there
+static void commitFailure(const fs::path &directory) {
+    fs::remove_all(directory);
+    Map durable;
+    pid_t child = fork();
+    check(child >= 0, "fork");
+    if (child == 0) {
+        Journaled::Options options;
+        options.waitForDurable = true;
+        options.checkpointBytes = 0;
+        Journaled tree(directory.string(), options);
+        for (size_t i = 0; i < 20; i++) {
+            tree.insert("kept" + to_string(i), i);
+        }
+        // the next commit grows the journal past the limit and fails
+        signal(SIGXFSZ, SIG_IGN);
+        rlimit limit{};
+        limit.rlim_cur = limit.rlim_max = rlim_t(fs::file_size(directory / "journal") + 8);
+        check(setrlimit(RLIMIT_FSIZE, &limit) == 0, "setrlimit");
+        check(throws<runtime_error>([&] { tree.insert(string(64, 'x'), 1); }), "failed commit reported");
+        size_t size = tree.size();
+        check(throws<runtime_error>([&] { tree.insert("refused", 2); }), "insert after the failure");
+        check(throws<runtime_error>([&] { tree.remove("kept0"); }), "remove after the failure");
+        check(throws<runtime_error>([&] { tree.update("kept1", [](size_t &value) { value++; }); }),
+              "update after the failure");
+        check(throws<runtime_error>([&] { tree.clear(); }), "clear after the failure");
+        check(tree.size() == size && !tree.contains("refused") && tree.get("kept1") == 1,
+              "refused writes left the tree alone");
+        exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "commit failure child");
+    for (size_t i = 0; i < 20; i++) {
+        durable.emplace("kept" + to_string(i), i);
+    }
+    Journaled tree(directory.string());
+    checkJournaled(tree, durable, "reopened after the failed commit");
+}
+
+int main() {
+    fs::path directory = fs::temp_directory_path() / ("avltree-journal-" + to_string(getpid()));
+    commitFailure(directory);
+    reopenAfterWrites(directory);
+    tornTails(directory);
+    crashDuringCheckpoint(directory);
+    fs::remove_all(directory);
+    cout << "journal recovery: ok" << endl;
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+#include "KeyCompare.h"
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define KEYCOMPARE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    // index of the first byte where a and b differ, or n
+    using MismatchKernel = size_t (*)(const char *a, const char *b, size_t n);
+
+    size_t mismatchScalar(const char *a, const char *b, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            std::uint64_t x, y;
+            std::memcpy(&x, a + i, 8);
+            std::memcpy(&y, b + i, 8);
+            if (x != y) {
+                std::uint64_t diff = x ^ y;
+                if constexpr (std::endian::native == std::endian::little) {
+                    return i + std::countr_zero(diff) / 8;
+                } else {
+                    return i + std::countl_zero(diff) / 8;
+                }
+            }
+        }
+        while (i < n && a[i] == b[i]) {
+            i++;
+        }
+        return i;
+    }
+
+#ifdef KEYCOMPARE_X86
+    __attribute__((target("sse2"))) size_t mismatchSse2(const char *a, const char *b, size_t n) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+            unsigned equal = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)));
+            if (equal != 0xFFFF) {
+                return i + std::countr_zero(~equal);
+            }
+        }
+        return i + mismatchScalar(a + i, b + i, n - i);
+    }
+
+    __attribute__((target("avx2"))) size_t mismatchAvx2(const char *a, const char *b, size_t n) {
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+            unsigned equal = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+            if (equal != 0xFFFFFFFFu) {
+                return i + std::countr_zero(~equal);
+            }
+        }
+        return i + mismatchSse2(a + i, b + i, n - i);
+    }
+#endif
+
+    struct KernelChoice {
+        MismatchKernel kernel;
+        const char *name;
+    };
+
+    // every kernel this CPU can run, fastest first
+    std::vector<KernelChoice> supportedKernels() {
+        std::vector<KernelChoice> kernels;
+#ifdef KEYCOMPARE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            kernels.push_back({mismatchAvx2, "avx2"});
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            kernels.push_back({mismatchSse2, "sse2"});
+        }
+#endif
+        kernels.push_back({mismatchScalar, "scalar"});
+        return kernels;
+    }
+
+    const std::vector<KernelChoice> &availableKernels() {
+        static const std::vector<KernelChoice> kernels = supportedKernels();
+        return kernels;
+    }
+
+    // the kernel compare uses: the fastest available unless useKernel chose another
+    std::atomic<const KernelChoice *> activeKernel{nullptr};
+
+    const KernelChoice &chosenKernel() {
+        const KernelChoice *choice = activeKernel.load(std::memory_order_relaxed);
+        return choice ? *choice : availableKernels().front();
+    }
+
+    // the chosen kernel, copied into an atomic so the hot path is one relaxed
+    // load instead of a guarded static; null until the first long compare
+    std::atomic<MismatchKernel> vectorKernel{nullptr};
+
+    // below this many bytes the 8-byte loop finishes before a vector kernel
+    // would pay for its call
+    constexpr size_t vectorThreshold = 32;
+}
+
+int KeyCompare::compare(std::string_view a, std::string_view b, size_t skip, size_t &common) {
+    size_t n = std::min(a.size(), b.size());
+    size_t i = std::min(skip, n);
+    if (n - i >= vectorThreshold) {
+        MismatchKernel kernel = vectorKernel.load(std::memory_order_relaxed);
+        if (!kernel) {
+            kernel = chosenKernel().kernel;
+            vectorKernel.store(kernel, std::memory_order_relaxed);
+        }
+        i += kernel(a.data() + i, b.data() + i, n - i);
+    } else {
+        i += mismatchScalar(a.data() + i, b.data() + i, n - i);
+    }
+    common = i;
+    if (i < n) {
+        return static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[i]) ? -1 : 1;
+    }
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+const char *KeyCompare::kernelName() {
+    return chosenKernel().name;
+}
+
+bool KeyCompare::useKernel(std::string_view name) {
+    for (const KernelChoice &choice : availableKernels()) {
+        if (name == choice.name) {
+            activeKernel.store(&choice, std::memory_order_relaxed);
+            vectorKernel.store(choice.kernel, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
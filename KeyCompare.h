@@ -0,0 +1,98 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * KeyCompare.h
+ */
+
+#ifndef KEYCOMPARE_H
+#define KEYCOMPARE_H
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Byte-wise three-way comparison of strings. The first mismatching byte is
+// found 32 (AVX2) or 16 (SSE2) bytes at a time, picked by a CPU check on
+// first use, and 8 bytes at a time elsewhere. Order matches
+// std::string::compare: unsigned bytes, then length.
+class KeyCompare {
+public:
+    // negative, zero or positive as a orders before, equal to or after b. The
+    // first skip bytes are known to be equal and are not read; common receives
+    // the length of the shared prefix
+    static int compare(std::string_view a, std::string_view b, size_t skip, size_t &common);
+
+    static int compare(std::string_view a, std::string_view b) {
+        size_t common;
+        return compare(a, b, 0, common);
+    }
+
+    // "avx2", "sse2" or "scalar"
+    static const char *kernelName();
+
+    // makes compare use the named kernel from now on instead of the one the
+    // CPU check picked, so tests and benchmarks can run each in turn. False,
+    // changing nothing, when the name is unknown or this CPU lacks the kernel
+    static bool useKernel(std::string_view name);
+};
+
+// true when Compare orders Key exactly like KeyCompare orders bytes and K can
+// be viewed as bytes too
+template<typename Key, typename Compare, typename K = Key>
+concept ByteOrdered = std::is_same_v<Key, std::string> &&
+                      (std::is_same_v<Compare, std::less<> > || std::is_same_v<Compare, std::less<std::string> >) &&
+                      std::is_convertible_v<const K &, std::string_view>;
+
+// One three-way comparison per node for a walk down a search tree. With
+// byte-ordered string keys it also tracks how many leading bytes the search key
+// shares with the nearest keys passed on either side; every key below lies
+// between those two, so it shares at least the smaller count with the search
+// key and those bytes are skipped. URL-like keys with long common prefixes
+// then compare only the bytes after the prefix. Other keys fall back to two
+// calls of the comparator.
+template<typename Key, typename Compare, typename K>
+class KeyDescent {
+public:
+    KeyDescent(const Compare &comp, const K &key) : comp(comp), key(key) {
+    }
+
+    // negative when the search key orders before nodeKey (the walk goes left),
+    // positive when after, zero when equal
+    int operator()(const Key &nodeKey) {
+        if constexpr (byteOrdered) {
+            size_t common;
+            int order = KeyCompare::compare(key, nodeKey, std::min(lowCommon, highCommon), common);
+            // an equal key may send the walk either way (lower_bound goes left,
+            // upper_bound right), so it tightens neither bound
+            if (order < 0) {
+                highCommon = common;
+            } else if (order > 0) {
+                lowCommon = common;
+            }
+            return order;
+        } else {
+            if (comp(key, nodeKey)) {
+                return -1;
+            }
+            return comp(nodeKey, key) ? 1 : 0;
+        }
+    }
+
+private:
+    static constexpr bool byteOrdered = ByteOrdered<Key, Compare, K>;
+
+    const Compare &comp;
+    // viewed once, so a const char* key is measured once rather than per node
+    std::conditional_t<byteOrdered, std::string_view, const K &> key;
+    size_t lowCommon = 0; // shared with the largest key passed that is below the search key
+    size_t highCommon = 0; // shared with the smallest key passed that is above it
+};
+
+#endif //KEYCOMPARE_H
@@ -0,0 +1,98 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for KeyCompare: every kernel this CPU has is pinned in turn and
+checked against std::string_view::compare at lengths around the 8, 16 and 32
+byte strides, with the mismatch at every position and every skip, then used
+for string lookups in AVLTree against std::map.
+ */
+#include "KeyCompare.h"
+#include "AVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+using namespace std;
+
+static int sign(int order) {
+    return (order > 0) - (order < 0);
+}
+
+// compare's result and shared prefix against the standard library
+static void checkPair(const string &a, const string &b, size_t skip, const string &what) {
+    size_t common = 0;
+    int order = KeyCompare::compare(a, b, skip, common);
+    check(sign(order) == sign(string_view(a).compare(b)), what + ": order");
+    size_t expectedCommon = size_t(mismatch(a.begin(), a.begin() + min(a.size(), b.size()), b.begin()).first -
+                                   a.begin());
+    check(common == expectedCommon, what + ": common prefix");
+}
+
+static void checkKernel(const string &kernel) {
+    mt19937 random(17);
+    for (size_t length = 0; length <= 70; length++) {
+        string a(length, 'x');
+        for (char &c : a) {
+            c = char(random() % 256); // bytes above 0x7f order as unsigned
+        }
+        string what = kernel + ", length " + to_string(length);
+        checkPair(a, a, 0, what + " equal");
+        // one longer, one shorter: a proper prefix orders first
+        checkPair(a, a + 'a', 0, what + " prefix");
+        if (length > 0) {
+            checkPair(a, a.substr(0, length - 1), 0, what + " longer");
+        }
+        for (size_t position = 0; position < length; position++) {
+            string b = a;
+            b[position] = char(b[position] ^ (1 + random() % 255));
+            string at = what + ", mismatch at " + to_string(position);
+            checkPair(a, b, 0, at);
+            checkPair(b, a, 0, at + " swapped");
+            // known-equal leading bytes are skipped, never past the mismatch
+            checkPair(a, b, position, at + ", skip to it");
+            checkPair(a, b, position / 2, at + ", skip half");
+        }
+        // a skip longer than both strings stops at the shorter one
+        checkPair(a, a + "zz", length + 5, what + " skip past the end");
+    }
+}
+
+// string keys with long shared prefixes, compared by the pinned kernel
+static void checkLookups(const string &kernel) {
+    mt19937 random(18);
+    AVLTree<string, size_t> tree;
+    map<string, size_t> reference;
+    string stem = "https://example.com/a/very/long/shared/path/segment/";
+    for (size_t i = 0; i < 4000; i++) {
+        string key = stem.substr(0, random() % stem.size()) + to_string(random() % 3000);
+        check(tree.insert(key, i) == reference.emplace(key, i).second, kernel + ": insert");
+    }
+    checkTree(tree, reference, kernel + ": url keys");
+    for (const auto &[key, value] : reference) {
+        check(tree.get(key) == value, kernel + ": get");
+        check(!tree.contains(key + '\0'), kernel + ": missing key one byte longer");
+    }
+}
+
+int main() {
+    cout << "default kernel: " << KeyCompare::kernelName() << endl;
+    check(!KeyCompare::useKernel("neon512"), "unknown kernel is refused");
+    for (string kernel : {"avx2", "sse2", "scalar"}) {
+        if (!KeyCompare::useKernel(kernel)) {
+            cout << kernel << ": not supported here, skipped" << endl;
+            continue;
+        }
+        check(KeyCompare::kernelName() == kernel, kernel + ": kernelName reports the pinned kernel");
+        checkKernel(kernel);
+        checkLookups(kernel);
+    }
+    cout << "key compare: ok" << endl;
+    return 0;
+}
@@ -0,0 +1,13 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+#include "ShardedAVLTree.h"
+#include <string>
+
+// member definitions live in ShardedAVLTree.tpp, the default string -> size_t
+// tree is instantiated here once
+template class ShardedAVLTree<std::string, size_t>;
@@ -0,0 +1,204 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * ShardedAVLTree.h
+ */
+
+#ifndef SHARDEDAVLTREE_H
+#define SHARDEDAVLTREE_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "AVLTree.h"
+#include "EpochDomain.h"
+
+// Ordered map for many concurrent writers. The key space is cut into ranges at
+// split points and each range lives in its own AVLTree behind its own lock, so
+// writers to different ranges never wait for each other. Readers take the
+// shard lock shared.
+//
+// Split points adapt to the load. Every shard counts its writes, and when one
+// shard carries more than imbalanceRatio times the average of the others
+// (entries plus writes since the last re-cut), all shards are joined into one
+// tree and split again at load-weighted quantiles. AVLTree::join and split
+// make that O(shards * log n) under the locks, with no entry copied. The
+// current split points are published through EpochDomain, so routing a key
+// takes no lock; a writer that routed just before a re-cut notices after
+// locking and routes again.
+//
+// Ranges are disjoint and ordered, so findRange and forEachInRange visit the
+// shards they overlap left to right, holding all of them at once for a
+// consistent result.
+template<typename Key = std::string, typename Value = size_t, typename Compare = std::less<> >
+class ShardedAVLTree {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+    using key_compare = Compare;
+    using Tree = AVLTree<Key, Value, Compare>;
+    using KeyParam = typename Tree::KeyParam;
+
+    // writes to one shard between checks for imbalance
+    static constexpr std::uint64_t rebalanceCheckInterval = 4096;
+
+    // a shard's load over the other shards' average that triggers a re-cut
+    static constexpr double imbalanceRatio = 2.0;
+
+    // no automatic re-cut while there are fewer entries than this per shard
+    static constexpr size_t minEntriesPerShard = 64;
+
+    // one shard per hardware thread
+    ShardedAVLTree();
+
+    explicit ShardedAVLTree(size_t shardCount, const Compare &comp = Compare());
+
+    // starts with these split points, strictly increasing, one shard more than points
+    explicit ShardedAVLTree(std::vector<Key> splitPoints, const Compare &comp = Compare());
+
+    ShardedAVLTree(const ShardedAVLTree &) = delete;
+
+    ShardedAVLTree &operator=(const ShardedAVLTree &) = delete;
+
+    // no other thread may be using the tree any more
+    ~ShardedAVLTree();
+
+    bool insert(KeyParam key, const Value &value);
+
+    // true if key was inserted, false if an existing value was replaced
+    bool insert_or_assign(KeyParam key, const Value &value);
+
+    bool remove(KeyParam key);
+
+    // removes every entry with a key in [lowKey, highKey], see AVLTree::eraseRange
+    size_t eraseRange(KeyParam lowKey, KeyParam highKey);
+
+    void clear();
+
+    bool contains(KeyParam key) const;
+
+    std::optional<Value> get(KeyParam key) const;
+
+    template<typename K> requires TransparentCompare<Compare>
+    bool contains(const K &key) const;
+
+    template<typename K> requires TransparentCompare<Compare>
+    std::optional<Value> get(const K &key) const;
+
+    // copies of every key in [lowKey, highKey], in order
+    std::vector<Key> findRange(KeyParam lowKey, KeyParam highKey) const;
+
+    // calls visit(key, value) for entries with keys in [lowKey, highKey] in
+    // ascending order, stopping after limit entries or when visit returns
+    // false. The shards involved are locked for reading during the call, so
+    // visit must not write to this tree
+    template<typename Visitor>
+    size_t forEachInRange(KeyParam lowKey, KeyParam highKey, Visitor &&visit,
+                          size_t limit = std::numeric_limits<size_t>::max()) const;
+
+    // every entry in ascending order, under the same rules as forEachInRange
+    template<typename Visitor>
+    size_t forEach(Visitor &&visit, size_t limit = std::numeric_limits<size_t>::max()) const;
+
+    std::vector<Key> keys() const;
+
+    // exact when no write is in progress
+    size_t size() const;
+
+    bool empty() const;
+
+    // re-cuts the split points now, whatever the load
+    void rebalance();
+
+    size_t shardCount() const;
+
+    std::vector<Key> splitPoints() const;
+
+    // AVLTree::verify on every shard, plus each shard's keys lying in its range
+    // and its entry count matching. Locks every shard for reading; throws
+    // std::logic_error naming the first broken invariant
+    void verify() const;
+
+private:
+    struct alignas(64) Shard {
+        mutable std::shared_mutex lock;
+        Tree tree; // everything below except the atomics is guarded by lock
+        // the layout this shard's contents were cut for
+        std::uint64_t generation = 0;
+        // tree.size() and the write count, readable without the lock
+        std::atomic<size_t> entries{0};
+        std::atomic<std::uint64_t> writes{0};
+        std::uint64_t writesAtRecut = 0; // belongs to whoever holds rebalanceLock
+
+        explicit Shard(const Compare &comp) : tree(comp) {
+        }
+    };
+
+    // shard i holds the keys in [splitPoints[i - 1], splitPoints[i])
+    struct Layout {
+        std::uint64_t generation;
+        std::vector<Key> splitPoints;
+    };
+
+    using ReadLock = std::shared_lock<std::shared_mutex>;
+    using WriteLock = std::unique_lock<std::shared_mutex>;
+
+    std::vector<std::unique_ptr<Shard> > shards;
+    std::atomic<const Layout *> layout;
+    [[no_unique_address]] Compare comp;
+
+    std::mutex rebalanceLock;
+    std::vector<std::pair<std::uint64_t, const Layout *> > retired; // (epoch tag, old layout), oldest first
+
+    template<typename K>
+    size_t shardFor(const Layout &current, const K &key) const;
+
+    // runs fn(shard) on the shard owning key with that shard locked by Lock,
+    // routing again if a re-cut moved the key's range in the meantime
+    template<typename Lock, typename K, typename Fn>
+    decltype(auto) withShard(const K &key, Fn &&fn) const;
+
+    // withShard for writers, counts the write and checks the balance afterwards
+    template<typename K, typename Fn>
+    decltype(auto) writeShard(const K &key, Fn &&fn);
+
+    // runs fn(shard) on every shard overlapping [lowKey, highKey] in order, all
+    // locked by Lock for the whole walk; fn returns false to stop early
+    template<typename Lock, typename Fn>
+    void withRange(KeyParam lowKey, KeyParam highKey, Fn &&fn) const;
+
+    // same over every shard
+    template<typename Lock, typename Fn>
+    void withAll(Fn &&fn) const;
+
+    // re-cuts if some shard's load is out of line, skipped while another
+    // thread is already re-cutting
+    void maybeRebalance();
+
+    // joins all shards and splits them again at load-weighted quantiles;
+    // caller holds rebalanceLock
+    void recut();
+
+    void reclaimLayouts();
+};
+
+#include "ShardedAVLTree.tpp"
+
+extern template class ShardedAVLTree<std::string, size_t>;
+
+#endif //SHARDEDAVLTREE_H
@@ -0,0 +1,456 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * ShardedAVLTree.tpp
+ * Member definitions for ShardedAVLTree, included at the bottom of ShardedAVLTree.h.
+ */
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+
+template<typename Key, typename Value, typename Compare>
+ShardedAVLTree<Key, Value, Compare>::ShardedAVLTree()
+    : ShardedAVLTree(std::max(1u, std::thread::hardware_concurrency())) {
+}
+
+template<typename Key, typename Value, typename Compare>
+ShardedAVLTree<Key, Value, Compare>::ShardedAVLTree(size_t shardCount, const Compare &comp)
+    : layout(nullptr), comp(comp) {
+    // no split points yet: every key routes to shard 0 until the first re-cut
+    // spreads them out, so a tree that stays small never pays for the others
+    if (shardCount == 0) {
+        throw std::invalid_argument("ShardedAVLTree needs at least one shard");
+    }
+    for (size_t i = 0; i < shardCount; i++) {
+        shards.push_back(std::make_unique<Shard>(comp));
+    }
+    layout.store(new Layout{0, {}});
+}
+
+template<typename Key, typename Value, typename Compare>
+ShardedAVLTree<Key, Value, Compare>::ShardedAVLTree(std::vector<Key> splitPoints, const Compare &comp)
+    : layout(nullptr), comp(comp) {
+    for (size_t i = 1; i < splitPoints.size(); i++) {
+        if (!comp(splitPoints[i - 1], splitPoints[i])) {
+            throw std::invalid_argument("ShardedAVLTree split points must be strictly increasing");
+        }
+    }
+    for (size_t i = 0; i <= splitPoints.size(); i++) {
+        shards.push_back(std::make_unique<Shard>(comp));
+    }
+    layout.store(new Layout{0, std::move(splitPoints)});
+}
+
+template<typename Key, typename Value, typename Compare>
+ShardedAVLTree<Key, Value, Compare>::~ShardedAVLTree() {
+    delete layout.load();
+    for (auto &[tag, old] : retired) {
+        delete old;
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K>
+size_t ShardedAVLTree<Key, Value, Compare>::shardFor(const Layout &current, const K &key) const {
+    // the number of split points at or below key
+    auto it = std::upper_bound(current.splitPoints.begin(), current.splitPoints.end(), key,
+                               [this](const K &k, const Key &point) { return comp(k, point); });
+    // a layout with fewer shards than we have only routes to its own
+    return std::min<size_t>(it - current.splitPoints.begin(), shards.size() - 1);
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename Lock, typename K, typename Fn>
+decltype(auto) ShardedAVLTree<Key, Value, Compare>::withShard(const K &key, Fn &&fn) const {
+    for (;;) {
+        size_t index;
+        std::uint64_t generation;
+        {
+            EpochDomain::Guard guard;
+            const Layout *current = layout.load();
+            index = shardFor(*current, key);
+            generation = current->generation;
+        }
+        Shard &shard = *shards[index];
+        Lock lock(shard.lock);
+        // re-cuts change every shard's generation while holding its lock, so a
+        // match means the key still belongs here
+        if (shard.generation == generation) {
+            return fn(shard);
+        }
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K, typename Fn>
+decltype(auto) ShardedAVLTree<Key, Value, Compare>::writeShard(const K &key, Fn &&fn) {
+    Shard *touched = nullptr;
+    auto result = withShard<WriteLock>(key, [&](Shard &shard) {
+        touched = &shard;
+        auto outcome = fn(shard.tree);
+        shard.entries.store(shard.tree.size(), std::memory_order_relaxed);
+        return outcome;
+    });
+    // checked with the shard unlocked, a re-cut takes every shard lock
+    if ((touched->writes.fetch_add(1, std::memory_order_relaxed) + 1) % rebalanceCheckInterval == 0) {
+        maybeRebalance();
+    }
+    return result;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename Lock, typename Fn>
+void ShardedAVLTree<Key, Value, Compare>::withRange(KeyParam lowKey, KeyParam highKey, Fn &&fn) const {
+    if (comp(highKey, lowKey)) {
+        return;
+    }
+    for (;;) {
+        size_t first, last;
+        std::uint64_t generation;
+        {
+            EpochDomain::Guard guard;
+            const Layout *current = layout.load();
+            first = shardFor(*current, lowKey);
+            last = shardFor(*current, highKey);
+            generation = current->generation;
+        }
+        // locked in index order like a re-cut does, so the two cannot deadlock
+        std::vector<Lock> locks;
+        locks.reserve(last - first + 1);
+        bool current = true;
+        for (size_t i = first; i <= last && current; i++) {
+            locks.emplace_back(shards[i]->lock);
+            current = shards[i]->generation == generation;
+        }
+        if (current) {
+            for (size_t i = first; i <= last; i++) {
+                if (!fn(*shards[i])) {
+                    break;
+                }
+            }
+            return;
+        }
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename Lock, typename Fn>
+void ShardedAVLTree<Key, Value, Compare>::withAll(Fn &&fn) const {
+    std::vector<Lock> locks;
+    locks.reserve(shards.size());
+    for (const auto &shard : shards) {
+        locks.emplace_back(shard->lock);
+    }
+    for (const auto &shard : shards) {
+        if (!fn(*shard)) {
+            break;
+        }
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+bool ShardedAVLTree<Key, Value, Compare>::insert(KeyParam key, const Value &value) {
+    return writeShard(key, [&](Tree &tree) { return tree.insert(key, value); });
+}
+
+template<typename Key, typename Value, typename Compare>
+bool ShardedAVLTree<Key, Value, Compare>::insert_or_assign(KeyParam key, const Value &value) {
+    return writeShard(key, [&](Tree &tree) { return tree.insert_or_assign(key, value).second; });
+}
+
+template<typename Key, typename Value, typename Compare>
+bool ShardedAVLTree<Key, Value, Compare>::remove(KeyParam key) {
+    return writeShard(key, [&](Tree &tree) { return tree.remove(key); });
+}
+
+template<typename Key, typename Value, typename Compare>
+size_t ShardedAVLTree<Key, Value, Compare>::eraseRange(KeyParam lowKey, KeyParam highKey) {
+    size_t erased = 0;
+    withRange<WriteLock>(lowKey, highKey, [&](Shard &shard) {
+        erased += shard.tree.eraseRange(lowKey, highKey);
+        shard.entries.store(shard.tree.size(), std::memory_order_relaxed);
+        return true;
+    });
+    return erased;
+}
+
+template<typename Key, typename Value, typename Compare>
+void ShardedAVLTree<Key, Value, Compare>::clear() {
+    withAll<WriteLock>([](Shard &shard) {
+        shard.tree.clear();
+        shard.entries.store(0, std::memory_order_relaxed);
+        return true;
+    });
+}
+
+template<typename Key, typename Value, typename Compare>
+bool ShardedAVLTree<Key, Value, Compare>::contains(KeyParam key) const {
+    return withShard<ReadLock>(key, [&](const Shard &shard) { return shard.tree.contains(key); });
+}
+
+template<typename Key, typename Value, typename Compare>
+std::optional<Value> ShardedAVLTree<Key, Value, Compare>::get(KeyParam key) const {
+    return withShard<ReadLock>(key, [&](const Shard &shard) { return shard.tree.get(key); });
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K> requires TransparentCompare<Compare>
+bool ShardedAVLTree<Key, Value, Compare>::contains(const K &key) const {
+    return withShard<ReadLock>(key, [&](const Shard &shard) { return shard.tree.contains(key); });
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K> requires TransparentCompare<Compare>
+std::optional<Value> ShardedAVLTree<Key, Value, Compare>::get(const K &key) const {
+    return withShard<ReadLock>(key, [&](const Shard &shard) { return shard.tree.get(key); });
+}
+
+template<typename Key, typename Value, typename Compare>
+std::vector<Key> ShardedAVLTree<Key, Value, Compare>::findRange(KeyParam lowKey, KeyParam highKey) const {
+    std::vector<Key> keys;
+    forEachInRange(lowKey, highKey, [&keys](const Key &key, const Value &) {
+        keys.push_back(key);
+    });
+    return keys;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename Visitor>
+size_t ShardedAVLTree<Key, Value, Compare>::forEachInRange(KeyParam lowKey, KeyParam highKey, Visitor &&visit,
+                                                           size_t limit) const {
+    size_t visited = 0;
+    bool stopped = false;
+    // shards hold disjoint ranges in order, so their walks concatenate into one
+    auto step = [&](const Key &key, const Value &value) {
+        if constexpr (std::is_same_v<std::invoke_result_t<Visitor &, const Key &, const Value &>, bool>) {
+            stopped = !visit(key, value);
+            return !stopped;
+        } else {
+            visit(key, value);
+            return true;
+        }
+    };
+    withRange<ReadLock>(lowKey, highKey, [&](const Shard &shard) {
+        visited += shard.tree.forEachInRange(lowKey, highKey, step, limit - visited);
+        return !stopped && visited < limit;
+    });
+    return visited;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename Visitor>
+size_t ShardedAVLTree<Key, Value, Compare>::forEach(Visitor &&visit, size_t limit) const {
+    size_t visited = 0;
+    withAll<ReadLock>([&](const Shard &shard) {
+        for (const auto &[key, value] : shard.tree) {
+            if (visited == limit) {
+                return false;
+            }
+            visited++;
+            if constexpr (std::is_same_v<std::invoke_result_t<Visitor &, const Key &, const Value &>, bool>) {
+                if (!visit(key, value)) {
+                    return false; // visitor asked to stop
+                }
+            } else {
+                visit(key, value);
+            }
+        }
+        return true;
+    });
+    return visited;
+}
+
+template<typename Key, typename Value, typename Compare>
+std::vector<Key> ShardedAVLTree<Key, Value, Compare>::keys() const {
+    std::vector<Key> keys;
+    withAll<ReadLock>([&keys](const Shard &shard) {
+        std::vector<Key> part = shard.tree.keys();
+        keys.insert(keys.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+        return true;
+    });
+    return keys;
+}
+
+template<typename Key, typename Value, typename Compare>
+size_t ShardedAVLTree<Key, Value, Compare>::size() const {
+    size_t total = 0;
+    for (const auto &shard : shards) {
+        total += shard->entries.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+template<typename Key, typename Value, typename Compare>
+bool ShardedAVLTree<Key, Value, Compare>::empty() const {
+    return size() == 0;
+}
+
+template<typename Key, typename Value, typename Compare>
+size_t ShardedAVLTree<Key, Value, Compare>::shardCount() const {
+    return shards.size();
+}
+
+template<typename Key, typename Value, typename Compare>
+std::vector<Key> ShardedAVLTree<Key, Value, Compare>::splitPoints() const {
+    EpochDomain::Guard guard;
+    return layout.load()->splitPoints;
+}
+
+template<typename Key, typename Value, typename Compare>
+void ShardedAVLTree<Key, Value, Compare>::verify() const {
+    EpochDomain::Guard guard;
+    const Layout *current = nullptr;
+    size_t index = 0;
+    withAll<ReadLock>([&](const Shard &shard) {
+        // the layout only changes with every shard locked, so it is stable from here on
+        if (!current) {
+            current = layout.load();
+        }
+        shard.tree.verify();
+        if (shard.entries.load(std::memory_order_relaxed) != shard.tree.size()) {
+            throw std::logic_error("ShardedAVLTree::verify: stale entry count");
+        }
+        if (shard.generation != current->generation) {
+            throw std::logic_error("ShardedAVLTree::verify: shard cut for another layout");
+        }
+        // keys are ordered within the shard, so its ends bound all of them
+        if (!shard.tree.empty() && (shardFor(*current, shard.tree.begin()->first) != index ||
+                                    shardFor(*current, shard.tree.rbegin()->first) != index)) {
+            throw std::logic_error("ShardedAVLTree::verify: key outside its shard's range");
+        }
+        index++;
+        return true;
+    });
+}
+
+template<typename Key, typename Value, typename Compare>
+void ShardedAVLTree<Key, Value, Compare>::rebalance() {
+    std::lock_guard<std::mutex> guard(rebalanceLock);
+    recut();
+}
+
+template<typename Key, typename Value, typename Compare>
+void ShardedAVLTree<Key, Value, Compare>::maybeRebalance() {
+    std::unique_lock<std::mutex> guard(rebalanceLock, std::try_to_lock);
+    if (!guard.owns_lock()) {
+        return; // someone else is re-cutting already
+    }
+    size_t entries = 0;
+    std::uint64_t totalLoad = 0;
+    std::uint64_t maxLoad = 0;
+    for (const auto &shard : shards) {
+        size_t shardEntries = shard->entries.load(std::memory_order_relaxed);
+        std::uint64_t load = shardEntries + shard->writes.load(std::memory_order_relaxed) - shard->writesAtRecut;
+        entries += shardEntries;
+        totalLoad += load;
+        maxLoad = std::max(maxLoad, load);
+    }
+    // measured against the other shards' average: against the overall average,
+    // which includes the busiest shard itself, two shards could never qualify
+    size_t others = shards.size() - 1;
+    if (others > 0 && entries >= minEntriesPerShard * shards.size() &&
+        double(maxLoad) > imbalanceRatio * double(totalLoad - maxLoad) / double(others)) {
+        recut();
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+void ShardedAVLTree<Key, Value, Compare>::recut() {
+    std::vector<WriteLock> locks;
+    locks.reserve(shards.size());
+    for (const auto &shard : shards) {
+        locks.emplace_back(shard->lock);
+    }
+
+    // a shard's load is its entries plus its recent writes, assumed spread
+    // evenly over its entries; the new cuts give every shard an equal share
+    size_t count = shards.size();
+    std::vector<std::uint64_t> loads(count);
+    std::vector<size_t> sizes(count);
+    std::uint64_t totalLoad = 0;
+    for (size_t i = 0; i < count; i++) {
+        Shard &shard = *shards[i];
+        sizes[i] = shard.tree.size();
+        loads[i] = sizes[i] + (shard.writes.load(std::memory_order_relaxed) - shard.writesAtRecut);
+        totalLoad += loads[i];
+    }
+    size_t totalSize = 0;
+    for (size_t size : sizes) {
+        totalSize += size;
+    }
+    if (count == 1 || totalSize == 0) {
+        return; // nothing to cut at
+    }
+
+    // ranks of the new split points in the joined tree, non-decreasing
+    std::vector<size_t> ranks;
+    ranks.reserve(count - 1);
+    size_t shard = 0;
+    size_t rankBefore = 0; // entries in shards before shard
+    std::uint64_t loadBefore = 0;
+    for (size_t cut = 1; cut < count; cut++) {
+        double target = double(totalLoad) * double(cut) / double(count);
+        while (shard + 1 < count && double(loadBefore + loads[shard]) <= target) {
+            loadBefore += loads[shard];
+            rankBefore += sizes[shard];
+            shard++;
+        }
+        size_t rank = rankBefore;
+        if (loads[shard] > 0) {
+            rank += size_t(double(sizes[shard]) * (target - double(loadBefore)) / double(loads[shard]));
+        }
+        rank = std::min(rank, totalSize - 1);
+        if (!ranks.empty()) {
+            // keep the points distinct while there are keys to spare
+            rank = std::max(rank, std::min(ranks.back() + 1, totalSize - 1));
+        }
+        ranks.push_back(rank);
+    }
+
+    Tree all(comp);
+    for (const auto &each : shards) {
+        all.join(each->tree);
+    }
+    std::vector<Key> points;
+    points.reserve(count - 1);
+    for (size_t rank : ranks) {
+        points.push_back(all.select(rank)->first);
+    }
+    // carve from the top down; a repeated point leaves an empty shard between
+    for (size_t i = count - 1; i > 0; i--) {
+        shards[i]->tree = all.split(points[i - 1]);
+    }
+    shards[0]->tree = std::move(all);
+
+    const Layout *old = layout.load();
+    std::uint64_t generation = old->generation + 1;
+    for (const auto &each : shards) {
+        each->generation = generation;
+        each->entries.store(each->tree.size(), std::memory_order_relaxed);
+        each->writesAtRecut = each->writes.load(std::memory_order_relaxed);
+    }
+    layout.store(new Layout{generation, std::move(points)});
+    // tagged after the store, as in ConcurrentAVLTree::publish
+    retired.emplace_back(EpochDomain::instance().currentEpoch(), old);
+    reclaimLayouts();
+}
+
+template<typename Key, typename Value, typename Compare>
+void ShardedAVLTree<Key, Value, Compare>::reclaimLayouts() {
+    EpochDomain &domain = EpochDomain::instance();
+    domain.advance();
+    std::uint64_t safe = domain.safeEpoch();
+    auto firstKept = std::find_if(retired.begin(), retired.end(), [safe](const auto &entry) {
+        return entry.first >= safe;
+    });
+    for (auto it = retired.begin(); it != firstKept; ++it) {
+        delete it->second;
+    }
+    retired.erase(retired.begin(), firstKept);
+}
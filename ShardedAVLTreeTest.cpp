@@ -0,0 +1,220 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/*
+Driver code for ShardedAVLTree: automatic and explicit re-cuts (including the
+two shard case), range queries across shard boundaries, and concurrent writers
+on overlapping ranges while readers scan, checked against std::map.
+ */
+#include "ShardedAVLTree.h"
+#include "AVLTreeTestSupport.h"
+#include <atomic>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+using namespace std;
+
+using Tree = ShardedAVLTree<int, int>;
+using Map = map<int, int>;
+
+// verify() plus every entry, in order, through forEach
+static void checkSharded(const Tree &tree, const Map &reference, const string &what) {
+    try {
+        tree.verify();
+    } catch (const exception &error) {
+        check(false, what + ": " + error.what());
+    }
+    check(tree.size() == reference.size() && tree.empty() == reference.empty(), what + ": size");
+    auto entry = reference.begin();
+    size_t visited = tree.forEach([&](const int &key, const int &value) {
+        check(entry != reference.end() && key == entry->first && value == entry->second, what + ": entries");
+        ++entry;
+    });
+    check(visited == reference.size() && entry == reference.end(), what + ": entry count");
+    vector<int> points = tree.splitPoints();
+    for (size_t i = 1; i < points.size(); i++) {
+        check(points[i - 1] <= points[i], what + ": split points in order");
+    }
+}
+
+// with two shards the busy one is measured against the idle one; against the
+// overall average it could never count as imbalanced
+static void twoShardsRecut() {
+    Tree tree(2);
+    Map reference;
+    check(tree.splitPoints().empty(), "starts with no split points");
+    int keys = int(Tree::rebalanceCheckInterval);
+    // the first balance check comes with the interval's last write
+    for (int key = 0; key < keys; key++) {
+        tree.insert(key, key);
+        reference.emplace(key, key);
+    }
+    vector<int> points = tree.splitPoints();
+    check(points.size() == 1, "two shards get a split point");
+    check(points[0] > 0 && points[0] < keys, "split point inside the keys");
+    checkSharded(tree, reference, "two shards");
+}
+
+static void automaticRecuts() {
+    for (size_t shardCount : {1, 3, 8}) {
+        Tree tree(shardCount);
+        Map reference;
+        mt19937 random(unsigned(22 + shardCount));
+        string what = to_string(shardCount) + " shards";
+        // ascending keys keep landing in the last shard, forcing repeated re-cuts
+        for (int key = 0; key < 60000; key++) {
+            tree.insert(key, key);
+            reference.emplace(key, key);
+        }
+        check(tree.splitPoints().size() == shardCount - 1, what + ": every shard has a range");
+        checkSharded(tree, reference, what + ": ascending inserts");
+
+        for (int i = 0; i < 40000; i++) {
+            int key = int(random() % 80000);
+            switch (random() % 3) {
+                case 0:
+                    check(tree.remove(key) == (reference.erase(key) == 1), what + ": remove");
+                    break;
+                case 1: {
+                    bool inserted = reference.find(key) == reference.end();
+                    reference[key] = i;
+                    check(tree.insert_or_assign(key, i) == inserted, what + ": insert_or_assign");
+                    break;
+                }
+                default:
+                    check(tree.get(key) == (reference.contains(key) ? optional(reference[key]) : nullopt),
+                          what + ": get");
+                    break;
+            }
+        }
+        checkSharded(tree, reference, what + ": random writes");
+        tree.rebalance();
+        checkSharded(tree, reference, what + ": explicit rebalance");
+    }
+}
+
+// ranges that start, end and stop inside different shards
+static void rangesAcrossShards() {
+    Tree tree(vector<int>{1000, 2000, 3000});
+    Map reference;
+    for (int key = 0; key < 4000; key += 3) {
+        tree.insert(key, key);
+        reference.emplace(key, key);
+    }
+    checkSharded(tree, reference, "fixed split points");
+    mt19937 random(23);
+    for (int round = 0; round < 300; round++) {
+        int low = int(random() % 4200) - 100;
+        int high = low + int(random() % 2500) - 100;
+        vector<int> expected;
+        if (low <= high) {
+            for (auto it = reference.lower_bound(low); it != reference.upper_bound(high); ++it) {
+                expected.push_back(it->first);
+            }
+        }
+        string what = "[" + to_string(low) + ", " + to_string(high) + "]";
+        check(tree.findRange(low, high) == expected, what + ": findRange");
+        vector<int> limited;
+        size_t limit = random() % 50;
+        size_t visited = tree.forEachInRange(low, high, [&limited](const int &key, const int &) {
+            limited.push_back(key);
+        }, limit);
+        check(visited == min(limit, expected.size()) &&
+              equal(limited.begin(), limited.end(), expected.begin()), what + ": forEachInRange limit");
+    }
+    check(tree.eraseRange(500, 3500) == size_t(distance(reference.lower_bound(500), reference.upper_bound(3500))),
+          "eraseRange across shards");
+    reference.erase(reference.lower_bound(500), reference.upper_bound(3500));
+    checkSharded(tree, reference, "after eraseRange");
+    tree.clear();
+    checkSharded(tree, Map(), "after clear");
+}
+
+static void badArguments() {
+    check(throws<invalid_argument>([] { Tree tree(size_t(0)); }), "no shards refused");
+    check(throws<invalid_argument>([] { Tree tree(vector<int>{5, 5}); }), "repeated split points refused");
+    check(throws<invalid_argument>([] { Tree tree(vector<int>{5, 1}); }), "descending split points refused");
+}
+
+// writers on interleaved keys force re-cuts while readers scan; afterwards the
+// tree must hold exactly what the writers left
+static void concurrentWriters() {
+    constexpr int writerCount = 4;
+    constexpr int keysPerWriter = 20000;
+    Tree tree(4);
+    atomic<bool> done{false};
+    vector<thread> readers;
+    for (int r = 0; r < 2; r++) {
+        readers.emplace_back([&tree, &done, r] {
+            mt19937 random(static_cast<unsigned>(r));
+            while (!done.load()) {
+                int low = int(random() % (writerCount * keysPerWriter));
+                int previous = low - 1;
+                // a scan holds every shard it visits, so it sees ascending keys
+                tree.forEachInRange(low, low + 2000, [&previous](const int &key, const int &value) {
+                    check(key > previous && value == key, "concurrent scan in order");
+                    previous = key;
+                }, 200);
+                this_thread::yield();
+            }
+        });
+    }
+    vector<thread> writers;
+    for (int w = 0; w < writerCount; w++) {
+        writers.emplace_back([&tree, w] {
+            // writer w owns the keys equal to w modulo writerCount
+            for (int i = 0; i < keysPerWriter; i++) {
+                int key = i * writerCount + w;
+                tree.insert(key, key);
+                if (i % 3 == 0) {
+                    tree.remove(key);
+                }
+            }
+        });
+    }
+    for (thread &writer : writers) {
+        writer.join();
+    }
+    done.store(true);
+    for (thread &reader : readers) {
+        reader.join();
+    }
+    Map reference;
+    for (int w = 0; w < writerCount; w++) {
+        for (int i = 0; i < keysPerWriter; i++) {
+            if (i % 3 != 0) {
+                reference.emplace(i * writerCount + w, i * writerCount + w);
+            }
+        }
+    }
+    checkSharded(tree, reference, "concurrent writers");
+}
+
+static void stringKeys() {
+    ShardedAVLTree<string, size_t> tree(vector<string>{"m"});
+    for (string key : {"apple", "zebra", "mango", "kiwi"}) {
+        tree.insert(key, key.size());
+    }
+    check(tree.get(string_view("zebra")) == 5 && tree.contains(string_view("kiwi")), "transparent lookups");
+    check(!tree.contains(string_view("m")), "split point itself is not a key");
+    tree.verify();
+}
+
+int main() {
+    twoShardsRecut();
+    automaticRecuts();
+    rangesAcrossShards();
+    badArguments();
+    concurrentWriters();
+    stringKeys();
+    cout << "sharded: ok" << endl;
+    return 0;
+}
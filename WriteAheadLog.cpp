@@ -0,0 +1,273 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+#include "WriteAheadLog.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define WRITEAHEADLOG_FSYNC 1
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // length, checksum and sequence number ahead of every payload
+    constexpr size_t frameBytes = 16;
+
+    constexpr std::array<std::uint32_t, 256> makeCrcTable() {
+        std::array<std::uint32_t, 256> table{};
+        for (std::uint32_t i = 0; i < 256; i++) {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0);
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    constexpr std::array<std::uint32_t, 256> crcTable = makeCrcTable();
+
+    // CRC-32 (the zlib polynomial) over the sequence number and the payload
+    std::uint32_t checksum(std::uint64_t sequence, std::string_view payload) {
+        std::uint32_t crc = 0xFFFFFFFFu;
+        auto feed = [&crc](const char *data, size_t size) {
+            for (size_t i = 0; i < size; i++) {
+                crc = crcTable[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+            }
+        };
+        feed(reinterpret_cast<const char *>(&sequence), sizeof(sequence));
+        feed(payload.data(), payload.size());
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    void syncToDisk(std::FILE *file) {
+#ifdef WRITEAHEADLOG_FSYNC
+#if defined(__APPLE__)
+        int result = ::fsync(::fileno(file));
+#else
+        int result = ::fdatasync(::fileno(file));
+#endif
+        if (result != 0) {
+            throw std::runtime_error("syncing the write-ahead log failed");
+        }
+#else
+        (void) file; // the flush above is as far as standard C++ reaches
+#endif
+    }
+}
+
+WriteAheadLog::ReadResult WriteAheadLog::read(const std::string &path,
+                                              const std::function<void(std::uint64_t, std::string_view)> &visit) {
+    ReadResult result;
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return result;
+    }
+    std::uint64_t fileSize = std::filesystem::file_size(path);
+    std::vector<char> payload;
+    for (;;) {
+        char frame[frameBytes];
+        if (!in.read(frame, frameBytes)) {
+            break;
+        }
+        std::uint32_t length, crc;
+        std::uint64_t sequence;
+        std::memcpy(&length, frame, 4);
+        std::memcpy(&crc, frame + 4, 4);
+        std::memcpy(&sequence, frame + 8, 8);
+        // a length past the end of the file or a sequence going backwards is
+        // as torn as a bad checksum
+        if (length > fileSize - result.validBytes - frameBytes || sequence <= result.lastSequence) {
+            break;
+        }
+        payload.resize(length);
+        if (!in.read(payload.data(), length)) {
+            break;
+        }
+        std::string_view record(payload.data(), length);
+        if (checksum(sequence, record) != crc) {
+            break;
+        }
+        visit(sequence, record);
+        result.validBytes += frameBytes + length;
+        result.lastSequence = sequence;
+    }
+    return result;
+}
+
+WriteAheadLog::WriteAheadLog(const std::string &path, Options options, ReadResult existing)
+    : path(path), options(options), file(nullptr), nextSequence(existing.lastSequence + 1),
+      bufferedThrough(existing.lastSequence), durableThrough(existing.lastSequence),
+      fileBytes(existing.validBytes) {
+    std::error_code error;
+    if (std::filesystem::exists(path, error) && std::filesystem::file_size(path) > existing.validBytes) {
+        std::filesystem::resize_file(path, existing.validBytes); // drop the torn tail
+    }
+    file = std::fopen(path.c_str(), "ab");
+    if (!file) {
+        throw std::runtime_error("cannot open write-ahead log " + path);
+    }
+    committer = std::thread([this] { commitLoop(); });
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    committer.join();
+    std::fclose(file);
+}
+
+std::uint64_t WriteAheadLog::append(std::string_view payload) noexcept {
+    std::lock_guard<std::mutex> guard(lock);
+    std::uint64_t sequence = nextSequence++;
+    if (failure) {
+        return sequence; // nothing more reaches the file, callers hear of it elsewhere
+    }
+    char frame[frameBytes];
+    std::uint32_t length = std::uint32_t(payload.size());
+    std::uint32_t crc = checksum(sequence, payload);
+    std::memcpy(frame, &length, 4);
+    std::memcpy(frame + 4, &crc, 4);
+    std::memcpy(frame + 8, &sequence, 8);
+    size_t before = buffer.size();
+    try {
+        buffer.append(frame, frameBytes);
+        buffer.append(payload);
+    } catch (...) {
+        // a record that is not logged must not be followed by ones that are
+        buffer.resize(before);
+        failure = std::current_exception();
+        committed.notify_all();
+        return sequence;
+    }
+    bufferedThrough = sequence;
+    if (buffer.size() >= options.commitBytes) {
+        wake.notify_one();
+    }
+    return sequence;
+}
+
+void WriteAheadLog::checkUsable() const {
+    std::lock_guard<std::mutex> guard(lock);
+    throwIfFailed();
+}
+
+void WriteAheadLog::waitDurable(std::uint64_t sequence) {
+    std::unique_lock<std::mutex> guard(lock);
+    sequence = std::min(sequence, bufferedThrough);
+    if (durableThrough < sequence && !failure) {
+        urgent = true;
+        wake.notify_one();
+        committed.wait(guard, [&] { return durableThrough >= sequence || failure; });
+    }
+    throwIfFailed();
+}
+
+void WriteAheadLog::sync() {
+    waitDurable(lastSequence());
+}
+
+void WriteAheadLog::reset() {
+    std::unique_lock<std::mutex> guard(lock);
+    committed.wait(guard, [this] { return !writing; });
+    throwIfFailed();
+    buffer.clear();
+    std::fflush(file);
+    std::filesystem::resize_file(path, 0);
+    fileBytes = 0;
+    durableThrough = bufferedThrough;
+    committed.notify_all();
+}
+
+std::uint64_t WriteAheadLog::lastSequence() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return nextSequence - 1;
+}
+
+std::uint64_t WriteAheadLog::sizeBytes() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return fileBytes + buffer.size();
+}
+
+void WriteAheadLog::syncPath(const std::string &path) {
+#ifdef WRITEAHEADLOG_FSYNC
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path + " to sync it");
+    }
+    int result = ::fsync(fd);
+    ::close(fd);
+    if (result != 0) {
+        throw std::runtime_error("syncing " + path + " failed");
+    }
+#else
+    (void) path;
+#endif
+}
+
+void WriteAheadLog::commitLoop() {
+    std::unique_lock<std::mutex> guard(lock);
+    for (;;) {
+        wake.wait_for(guard, options.commitInterval, [this] {
+            return stopping || urgent || buffer.size() >= options.commitBytes;
+        });
+        if (buffer.empty()) {
+            urgent = false;
+            if (stopping) {
+                return;
+            }
+            continue;
+        }
+        // take the whole buffer and write it unlocked, appends carry on into a
+        // fresh one meanwhile
+        inFlight.clear();
+        inFlight.swap(buffer); // buffer takes over the last batch's capacity
+        std::uint64_t through = bufferedThrough;
+        urgent = false;
+        writing = true;
+        guard.unlock();
+        std::exception_ptr error;
+        try {
+            writeBatch(inFlight);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        guard.lock();
+        writing = false;
+        if (error) {
+            failure = error; // nothing after a lost batch can be trusted, stop here
+            committed.notify_all();
+            return;
+        }
+        fileBytes += inFlight.size();
+        durableThrough = std::max(durableThrough, through);
+        committed.notify_all();
+    }
+}
+
+void WriteAheadLog::writeBatch(const std::string &batch) {
+    if (std::fwrite(batch.data(), 1, batch.size(), file) != batch.size() || std::fflush(file) != 0) {
+        throw std::runtime_error("writing the write-ahead log failed");
+    }
+    syncToDisk(file);
+}
+
+void WriteAheadLog::throwIfFailed() const {
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ * Larry Smith
+ * Project #5
+ * CS 3100
+ * Map ADT: AVL Tree
+ * 11/19/2025
+ */
+/**
+ * WriteAheadLog.h
+ */
+
+#ifndef WRITEAHEADLOG_H
+#define WRITEAHEADLOG_H
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Append-only log of opaque records with group commit. append() only copies
+// the record into a memory buffer, so it costs well under a microsecond; a
+// background committer writes the buffer out and fsyncs it every
+// commitInterval, or sooner once commitBytes are waiting or someone waits for
+// durability. Every write and fsync therefore covers all records appended
+// since the last one, however many threads appended them.
+//
+// Each record is framed as length, CRC-32 and a sequence number starting at 1.
+// A crash can leave a torn record at the end; reading stops at the first
+// record that fails its checksum and opening the log cuts it off there.
+class WriteAheadLog {
+public:
+    struct Options {
+        // longest a record waits in memory before it is written and synced
+        std::chrono::microseconds commitInterval{2000};
+        // buffered bytes that start a commit early
+        size_t commitBytes = size_t(1) << 20;
+    };
+
+    // calls visit(sequence, payload) for every intact record in path, in order,
+    // and returns where the intact part ends; a missing file reads as empty
+    struct ReadResult {
+        std::uint64_t validBytes = 0;
+        std::uint64_t lastSequence = 0;
+    };
+
+    static ReadResult read(const std::string &path,
+                           const std::function<void(std::uint64_t, std::string_view)> &visit);
+
+    // opens path for appending, creating it if needed. existing is what read
+    // returned for path: anything past validBytes (a torn tail) is cut off and
+    // numbering continues after lastSequence. Throws std::runtime_error if the
+    // file cannot be opened
+    WriteAheadLog(const std::string &path, Options options, ReadResult existing);
+
+    WriteAheadLog(const WriteAheadLog &) = delete;
+
+    WriteAheadLog &operator=(const WriteAheadLog &) = delete;
+
+    // commits whatever is still buffered, then stops the committer
+    ~WriteAheadLog();
+
+    // buffers one record and returns its sequence number. Never throws, so a
+    // caller that checked checkUsable can change its state first and log it
+    // after: once a commit has failed the record is dropped, and one that
+    // cannot be buffered fails the log. Either way checkUsable, waitDurable
+    // and sync report the failure from then on
+    std::uint64_t append(std::string_view payload) noexcept;
+
+    // throws std::runtime_error (or what buffering threw) once the log has
+    // failed, so a caller can check before making a change it could not log
+    void checkUsable() const;
+
+    // blocks until the record with this sequence number and all before it are
+    // on disk, asking the committer not to wait out its interval
+    void waitDurable(std::uint64_t sequence);
+
+    // waits until everything appended so far is on disk
+    void sync();
+
+    // Drops every record, buffered or on disk, for a checkpoint that already
+    // holds their effects; numbering carries on where it was.
+    void reset();
+
+    std::uint64_t lastSequence() const;
+
+    // bytes in the file plus bytes still buffered
+    std::uint64_t sizeBytes() const;
+
+    // flushes a file or directory to disk (fsync), e.g. a directory after a
+    // rename in it; a no-op where the platform has no fsync
+    static void syncPath(const std::string &path);
+
+private:
+    std::string path;
+    Options options;
+    std::FILE *file;
+
+    mutable std::mutex lock;
+    std::condition_variable wake; // the committer waits here
+    std::condition_variable committed; // writers waiting for durability wait here
+    std::string buffer; // framed records not yet handed to the committer
+    std::string inFlight; // the batch being written, touched only by the committer
+    std::uint64_t nextSequence;
+    std::uint64_t bufferedThrough; // sequence of the last record in buffer
+    std::uint64_t durableThrough; // every record up to here is on disk
+    std::uint64_t fileBytes;
+    bool urgent = false; // a writer is waiting, commit without delay
+    bool writing = false; // the committer is outside the lock writing a batch
+    bool stopping = false;
+    std::exception_ptr failure; // set if a commit or append failed, reported to every caller
+
+    std::thread committer;
+
+    void commitLoop();
+
+    // writes and fsyncs one batch, called without the lock held
+    void writeBatch(const std::string &batch);
+
+    void throwIfFailed() const;
+};
+
+#endif //WRITEAHEADLOG_H